@@ -0,0 +1,61 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "boot_profile.h"
+
+#if defined(BOOT_PROFILE)
+
+#include "stm32g4xx.h"
+
+uint32_t g_bootTimestamps[BOOT_PHASE_NUM];
+
+void BootProfile_Mark(uint32_t phase)
+{
+	if(phase < BOOT_PHASE_NUM) {
+		g_bootTimestamps[phase] = DWT->CYCCNT;
+	}
+}
+
+void BootProfile_Report(BootReport_t* report)
+{
+	uint32_t previous = g_bootTimestamps[BOOT_PHASE_RESET];
+
+	report->cycles[BOOT_PHASE_RESET] = previous;
+	for(uint32_t phase = BOOT_PHASE_DATA_COPY; phase < BOOT_PHASE_NUM; phase++) {
+		uint32_t stamp = g_bootTimestamps[phase];
+
+		if(stamp == 0U) {
+			report->cycles[phase] = 0U;
+			continue;
+		}
+		if(phase == BOOT_PHASE_CLOCK_READY) {
+			// completes asynchronously, measured from SystemInit
+			report->cycles[phase] = stamp - g_bootTimestamps[BOOT_PHASE_SYSTEM_INIT];
+			continue;
+		}
+		report->cycles[phase] = stamp - previous;
+		previous = stamp;
+	}
+	report->total = g_bootTimestamps[BOOT_PHASE_MAIN];
+}
+
+#endif
@@ -0,0 +1,82 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+/*
+ * Boot phase profiling
+ *
+ * With BOOT_PROFILE defined, Reset_Handler enables the DWT cycle counter right after reset and
+ * records the cycle count at the end of each boot phase in g_bootTimestamps[]. The header is also
+ * included by the startup assembly file, therefore the phase indices are plain defines.
+ */
+
+#define BOOT_PHASE_RESET			0	///< DWT cycle counter started in Reset_Handler
+#define BOOT_PHASE_DATA_COPY		1	///< .data copied from flash
+#define BOOT_PHASE_BSS_CLEAR		2	///< .bss zeroed
+#define BOOT_PHASE_SYSTEM_INIT		3	///< SystemInit() returned
+#define BOOT_PHASE_STATIC_CTORS		4	///< Static constructors done, main() is entered
+#define BOOT_PHASE_MAIN				5	///< Application start-up done (marked by main())
+#define BOOT_PHASE_CLOCK_READY		6	///< System clock switched to PLL (asynchronous with FAST_BOOT)
+#define BOOT_PHASE_NUM				7
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint32_t cycles[BOOT_PHASE_NUM];	///< Cycles spent in each phase (since the end of the previous one)
+	uint32_t total;						///< Cycles from reset to BOOT_PHASE_MAIN
+} BootReport_t;
+
+#if defined(BOOT_PROFILE)
+
+extern uint32_t g_bootTimestamps[BOOT_PHASE_NUM];
+
+/**
+ * @brief Records the current DWT cycle count as end of the given boot phase.
+ */
+void BootProfile_Mark(uint32_t phase);
+
+/**
+ * @brief Converts the recorded time stamps into per-phase cycle counts.
+ *
+ * Phases not reached (yet) report 0 cycles.
+ */
+void BootProfile_Report(BootReport_t* report);
+
+#else
+
+static inline void BootProfile_Mark(uint32_t phase) { (void)phase; }
+static inline void BootProfile_Report(BootReport_t* report) { (void)report; }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ASSEMBLER__ */
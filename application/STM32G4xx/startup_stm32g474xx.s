@@ -26,9 +26,11 @@
   ******************************************************************************
   */
 
+#include "boot_profile.h"
+
   .syntax unified
 	.cpu cortex-m4
-	.fpu softvfp
+	.fpu fpv4-sp-d16
 	.thumb
 
 .global	g_pfnVectors
@@ -45,8 +47,75 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the initialization values of the CCMSRAM code and data. defined in linker script */
+.word	_siccmram
+/* start/end address of CCMSRAM code and data. defined in linker script */
+.word	_sccmram
+.word	_eccmram
+/* start/end address of the CCMSRAM bss. defined in linker script */
+.word	_sccmbss
+.word	_eccmbss
 
 .equ  BootRAM,        0xF1E0F85F
+
+/**
+ * @brief  Copies the words from [r2] to [r0, r1) in 32 byte LDM/STM bursts
+ *         followed by single words for the rest. All addresses word aligned.
+ *         Uses r0-r4, r8-r12 and lr, keeps r5-r7.
+*/
+.macro INIT_COPY_WORDS
+  b 2f
+1:
+  ldmia r2!, {r3, r4, r8, r9, r10, r11, r12, lr}
+  stmia r0!, {r3, r4, r8, r9, r10, r11, r12, lr}
+2:
+  sub r3, r1, r0
+  cmp r3, #32
+  bhs 1b
+  b 4f
+3:
+  ldr r3, [r2], #4
+  str r3, [r0], #4
+4:
+  cmp r0, r1
+  bcc 3b
+.endm
+
+/**
+ * @brief  Fills the words in [r0, r1) with r3 in 32 byte STM bursts followed by
+ *         single words for the rest. All addresses word aligned.
+ *         Uses r0-r4, r8-r12 and lr, keeps r5-r7.
+*/
+.macro INIT_FILL_WORDS
+  mov r4, r3
+  mov r8, r3
+  mov r9, r3
+  mov r10, r3
+  mov r11, r3
+  mov r12, r3
+  mov lr, r3
+  b 2f
+1:
+  stmia r0!, {r3, r4, r8, r9, r10, r11, r12, lr}
+2:
+  sub r2, r1, r0
+  cmp r2, #32
+  bhs 1b
+  b 4f
+3:
+  str r3, [r0], #4
+4:
+  cmp r0, r1
+  bcc 3b
+.endm
+
+/**
+ * @brief  Zeroes the words in [r0, r1), see INIT_FILL_WORDS.
+*/
+.macro INIT_ZERO_WORDS
+  movs r3, #0
+  INIT_FILL_WORDS
+.endm
 /**
  * @brief  This is the code that gets called when the processor first
  *          starts execution following a reset event. Only the absolutely
@@ -63,41 +132,78 @@ Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
 
+#if defined(BOOT_PROFILE)
+/* Start the DWT cycle counter, r7 keeps the DWT base for the early time stamps */
+  ldr r0, =0xE000EDFC   /* CoreDebug->DEMCR */
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000   /* TRCENA */
+  str r1, [r0]
+  ldr r7, =0xE0001000   /* DWT->CTRL */
+  movs r1, #0
+  str r1, [r7, #4]      /* DWT->CYCCNT = 0 */
+  ldr r1, [r7]
+  orr r1, r1, #1        /* CYCCNTENA */
+  str r1, [r7]
+#endif
+
 /* Copy the data segment initializers from flash to SRAM */
   ldr r0, =_sdata
   ldr r1, =_edata
   ldr r2, =_sidata
-  movs r3, #0
-  b	LoopCopyDataInit
-
-CopyDataInit:
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-  adds r4, r0, r3
-  cmp r4, r1
-  bcc CopyDataInit
-  
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
-  movs r3, #0
-  b LoopFillZerobss
+  INIT_COPY_WORDS
 
-FillZerobss:
-  str  r3, [r2]
-  adds r2, r2, #4
+/* Copy the CCMSRAM code and data from flash */
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  INIT_COPY_WORDS
 
-LoopFillZerobss:
-  cmp r2, r4
-  bcc FillZerobss
+#if defined(BOOT_PROFILE)
+  ldr r5, [r7, #4]      /* time stamp: .data copied */
+#endif
+
+/* Zero fill the bss segment. */
+  ldr r0, =_sbss
+  ldr r1, =_ebss
+  INIT_ZERO_WORDS
+
+/* Zero fill the CCMSRAM bss */
+  ldr r0, =_sccmbss
+  ldr r1, =_eccmbss
+  INIT_ZERO_WORDS
+
+#if defined(BOOT_PROFILE)
+  ldr r6, [r7, #4]      /* time stamp: .bss cleared */
+/* g_bootTimestamps lives in .bss, store the early time stamps now that it is cleared */
+  ldr r0, =g_bootTimestamps
+  str r5, [r0, #(4 * BOOT_PHASE_DATA_COPY)]
+  str r6, [r0, #(4 * BOOT_PHASE_BSS_CLEAR)]
+#endif
+
+#if defined(STACK_PAINT)
+/* Paint the reserved main stack, nothing is stacked yet. The pattern must match diag::StackMonitor::Pattern */
+  ldr r0, =_sstack
+  ldr r1, =_estack
+  ldr r3, =0xA5A5A5A5
+  INIT_FILL_WORDS
+#endif
 
 /* Call the clock system initialization function.*/
     bl  SystemInit
+#if defined(BOOT_PROFILE)
+    movs r0, #BOOT_PHASE_SYSTEM_INIT
+    bl  BootProfile_Mark
+#endif
+#if defined(MPU_GUARD)
+/* Null-pointer trap and main stack guard, before any C++ code runs */
+    bl  Mpu_Setup
+#endif
 /* Call static constructors */
     bl __libc_init_array
+#if defined(BOOT_PROFILE)
+    movs r0, #BOOT_PHASE_STATIC_CTORS
+    bl  BootProfile_Mark
+#endif
 /* Call the application's entry point.*/
 	bl	main
 
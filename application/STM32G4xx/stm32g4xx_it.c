@@ -21,6 +21,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32g4xx_it.h"
+#include "stm32g4xx.h"
+#include "system_clock.h"
 
 /** @addtogroup STM32G4xx_HAL_Examples
   * @{
@@ -33,9 +35,34 @@
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
+/* Passes the exception frame of the active stack (MSP or PSP, EXC_RETURN bit 2)
+   and EXC_RETURN to the fault manager which records the fault and either resets
+   the MCU or recovers. The handler runs on FaultStack: the main stack may have
+   hit the MPU guard and the stack snapshot above the frame stays untouched.
+   Fault_Handler returns only after a recovery, then MSP is restored and the
+   exception returns through the modified frame. */
+#define FAULT_TO_HANDLER()                    \
+  __ASM volatile(                             \
+    "tst   lr, #4                      \n"    \
+    "ite   eq                          \n"    \
+    "mrseq r0, msp                     \n"    \
+    "mrsne r0, psp                     \n"    \
+    "mov   r1, lr                      \n"    \
+    "mrs   r2, msp                     \n"    \
+    "ldr   r3, =FaultStack + 512       \n"    \
+    "msr   msp, r3                     \n"    \
+    "push  {r1, r2}                    \n"    \
+    "bl    Fault_Handler               \n"    \
+    "pop   {r1, r2}                    \n"    \
+    "msr   msp, r2                     \n"    \
+    "bx    r1                          \n")
 /* Private variables ---------------------------------------------------------*/
+/* Stack of the fault handlers, referenced by name from FAULT_TO_HANDLER */
+__attribute__((used, aligned(8))) uint32_t FaultStack[128];
 
 /* Private function prototypes -----------------------------------------------*/
+void Fault_Handler(uint32_t* frame, uint32_t excReturn);
+
 /* Private functions ---------------------------------------------------------*/
 
 /******************************************************************************/
@@ -49,6 +76,10 @@
   */
 void NMI_Handler(void)
 {
+  if((RCC->CIFR & RCC_CIFR_CSSF) != 0U)
+  {
+    SystemClock_CssHandler();
+  }
 }
 
 /**
@@ -56,12 +87,9 @@ void NMI_Handler(void)
   * @param  None
   * @retval None
   */
-void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
-  /* Go to infinite loop when Hard Fault exception occurs */
-  while (1)
-  {
-  }
+  FAULT_TO_HANDLER();
 }
 
 /**
@@ -69,12 +97,9 @@ void HardFault_Handler(void)
   * @param  None
   * @retval None
   */
-void MemManage_Handler(void)
+__attribute__((naked)) void MemManage_Handler(void)
 {
-  /* Go to infinite loop when Memory Manage exception occurs */
-  while (1)
-  {
-  }
+  FAULT_TO_HANDLER();
 }
 
 /**
@@ -82,12 +107,9 @@ void MemManage_Handler(void)
   * @param  None
   * @retval None
   */
-void BusFault_Handler(void)
+__attribute__((naked)) void BusFault_Handler(void)
 {
-  /* Go to infinite loop when Bus Fault exception occurs */
-  while (1)
-  {
-  }
+  FAULT_TO_HANDLER();
 }
 
 /**
@@ -95,12 +117,9 @@ void BusFault_Handler(void)
   * @param  None
   * @retval None
   */
-void UsageFault_Handler(void)
+__attribute__((naked)) void UsageFault_Handler(void)
 {
-  /* Go to infinite loop when Usage Fault exception occurs */
-  while (1)
-  {
-  }
+  FAULT_TO_HANDLER();
 }
 
 /**
@@ -137,6 +156,7 @@ void PendSV_Handler(void)
   */
 void SysTick_Handler(void)
 {
+  SystemClock_TickHandler();
 }
 
 /******************************************************************************/
@@ -0,0 +1,82 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+/*
+ * Project specific extensions of system_stm32g4xx.c (clock bring-up and clock security system)
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	SYSCLK_SOURCE_HSI16 = 0,	///< Running on HSI16 (reset state, fast boot or failed PLL)
+	SYSCLK_SOURCE_PLL_HSE,		///< PLL running from the crystal
+	SYSCLK_SOURCE_PLL_HSI		///< PLL running from HSI16 after an HSE failure
+} SystemClockSource_t;
+
+typedef struct {
+	SystemClockSource_t source;			///< Current system clock source
+	uint32_t hseStartupFailures;		///< HSE did not get ready within HSE_STARTUP_TIMEOUT (HSE_STARTUP_TIMEOUT_MS when deferred)
+	uint32_t cssEvents;					///< HSE losses detected by the clock security system
+	uint32_t lastRecoveryCycles;		///< Core cycles from CSS NMI entry until the PLL runs again
+	uint32_t maxRecoveryCycles;			///< Worst case of lastRecoveryCycles
+} SystemClockStatus_t;
+
+extern volatile SystemClockStatus_t SystemClockStatus;
+
+/**
+ * @brief Hook called after every change of the system clock. Weak, empty default.
+ */
+void SystemCoreClockChanged(void);
+
+/**
+ * @brief Hook returning 1 if SystemInit() runs after a warm reset, which then defers the clock bring-up like
+ * FAST_BOOT. Weak default returns 0, the fault component overrides it.
+ */
+uint32_t SystemInit_IsWarmBoot(void);
+
+/**
+ * @brief HSE start-up timeout of the deferred clock bring-up (FAST_BOOT, warm boot). Called from SysTick_Handler.
+ *
+ * SystemInit() arms SysTick as a one-shot of HSE_STARTUP_TIMEOUT_MS. If HSE is not ready by then, the handler
+ * switches it off and starts the PLL from HSI16 instead, RCC_IRQHandler selects the PLL once it is locked.
+ * Returns immediately when no deferred bring-up is pending, so SysTick can be used by the application afterwards.
+ */
+void SystemClock_TickHandler(void);
+
+/**
+ * @brief Handles an HSE failure detected by the clock security system. Called from NMI_Handler.
+ *
+ * The hardware already switched SYSCLK to HSI16. The handler clears the CSS flag and restarts
+ * the PLL from HSI16. Execution time is bounded by PLL_LOCK_TIMEOUT; if the PLL does not lock the
+ * system keeps running on HSI16.
+ */
+void SystemClock_CssHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
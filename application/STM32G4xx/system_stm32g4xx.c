@@ -77,6 +77,8 @@
   */
 
 #include "stm32g4xx.h"
+#include "boot_profile.h"
+#include "system_clock.h"
 
 #if !defined  (HSE_VALUE)
   #define HSE_VALUE     24000000U /*!< Value of the External oscillator in Hz */
@@ -86,6 +88,22 @@
   #define HSI_VALUE    16000000U /*!< Value of the Internal oscillator in Hz*/
 #endif /* HSI_VALUE */
 
+#if !defined  (HSE_STARTUP_TIMEOUT)
+  #define HSE_STARTUP_TIMEOUT  100000U /*!< Polling loops to wait for HSERDY before falling back to HSI16 */
+#endif /* HSE_STARTUP_TIMEOUT */
+
+#if !defined  (HSE_STARTUP_TIMEOUT_MS)
+  #define HSE_STARTUP_TIMEOUT_MS  100U /*!< SysTick one-shot bounding the HSE start-up of the deferred bring-up */
+#endif /* HSE_STARTUP_TIMEOUT_MS */
+
+#if !defined  (PLL_LOCK_TIMEOUT)
+  #define PLL_LOCK_TIMEOUT     10000U /*!< Polling loops to wait for PLLRDY */
+#endif /* PLL_LOCK_TIMEOUT */
+
+#define PLL_INPUT_VALUE        4000000U /*!< PLL input frequency after PLLM, VCO = 4 MHz * 85 = 340 MHz */
+#define PLL_N                  85U      /*!< PLLN multiplication factor */
+#define PLL_R_DIV2             0U       /*!< PLLR encoding for division by 2 => 170 MHz */
+
 /**
   * @}
   */
@@ -106,8 +124,32 @@
 /*!< Uncomment the following line if you need to relocate your vector Table in
      Internal SRAM. */
 /* #define VECT_TAB_SRAM */
+
+/*!< Define VECT_TAB_RAM_COPY to copy g_pfnVectors into g_ramVectors at boot so that
+     handlers can be installed at runtime (see mcal::VectorTable). The table is placed
+     in main SRAM, or in CCMSRAM if VECT_TAB_CCMSRAM is defined as well. */
+#define VECT_TAB_ENTRIES  (16U + 102U)  /*!< Cortex-M4 exceptions + STM32G474 interrupts */
 #define VECT_TAB_OFFSET  0x00UL /*!< Vector Table base offset field.
                                    This value must be a multiple of 0x200. */
+
+/*!< Flash ART accelerator setting applied by SystemInit(), selected with the FLASH_ACCEL
+     build option (FLASH_ACCEL_ALL, _CACHES, _PREFETCH or _NONE) or given directly with
+     -DFLASH_ACR_ACCEL_CONFIG=<ACR bits>. */
+#if !defined  (FLASH_ACR_ACCEL_CONFIG)
+  #if defined(FLASH_ACCEL_NONE)
+    #define FLASH_ACR_ACCEL_CONFIG  0UL
+  #elif defined(FLASH_ACCEL_PREFETCH)
+    #define FLASH_ACR_ACCEL_CONFIG  (FLASH_ACR_PRFTEN)
+  #elif defined(FLASH_ACCEL_CACHES)
+    #define FLASH_ACR_ACCEL_CONFIG  (FLASH_ACR_ICEN | FLASH_ACR_DCEN)
+  #else
+    #define FLASH_ACR_ACCEL_CONFIG  (FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN)
+  #endif
+#endif /* FLASH_ACR_ACCEL_CONFIG */
+
+/*!< CPACR full access for the FPU coprocessors, not provided by core_cm4.h */
+#define SCB_CPACR_CP10_Msk  (3UL << (10U * 2U))
+#define SCB_CPACR_CP11_Msk  (3UL << (11U * 2U))
 /******************************************************************************/
 /**
   * @}
@@ -134,6 +176,19 @@
   */
   uint32_t SystemCoreClock = HSI_VALUE;
 
+  volatile SystemClockStatus_t SystemClockStatus = { SYSCLK_SOURCE_HSI16, 0U, 0U, 0U, 0U };
+
+#if defined(VECT_TAB_RAM_COPY)
+  extern const uint32_t g_pfnVectors[VECT_TAB_ENTRIES];
+  /* VTOR requires the table to be aligned to its size rounded up to a power of two */
+#if defined(VECT_TAB_CCMSRAM)
+  __attribute__((section(".ccmram_bss"), aligned(512)))
+#else
+  __attribute__((aligned(512)))
+#endif
+  uint32_t g_ramVectors[VECT_TAB_ENTRIES];
+#endif
+
   const uint8_t AHBPrescTable[16] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U, 6U, 7U, 8U, 9U};
   const uint8_t APBPrescTable[8] =  {0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U};
 
@@ -145,6 +200,14 @@
   * @{
   */
 
+static void SystemClock_StartPll(uint32_t pllsource);
+static uint32_t SystemClock_WaitPllLocked(void);
+static void SystemClock_SwitchToPll(void);
+static void SystemClock_StopTimeout(void);
+
+/* Set while the deferred bring-up waits for HSE, SystemClock_TickHandler() then owns SysTick */
+static volatile uint32_t SystemClock_HsePending = 0U;
+
 /**
   * @}
   */
@@ -161,47 +224,277 @@
 
 void SystemInit(void)
 {
-	uint32_t	temp;
   /* FPU settings ------------------------------------------------------------*/
   #if (__FPU_PRESENT == 1) && (__FPU_USED == 1)
-    SCB->CPACR |= ((3UL << (10*2))|(3UL << (11*2)));  /* set CP10 and CP11 Full Access */
+    SCB->CPACR |= (SCB_CPACR_CP10_Msk | SCB_CPACR_CP11_Msk);  /* set CP10 and CP11 Full Access */
+
+    /* FP context stacking on exception entry, must be set before the first FP instruction */
+    #if defined(FPU_CONTEXT_NONE)
+    /* no FP context stacking: shortest ISR entry, only valid if no ISR uses the FPU */
+    FPU->FPCCR &= ~(FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+    #elif defined(FPU_CONTEXT_EAGER)
+    /* S0-S15 and FPSCR are stacked on every exception entry of an FP context */
+    FPU->FPCCR = (FPU->FPCCR | FPU_FPCCR_ASPEN_Msk) & ~FPU_FPCCR_LSPEN_Msk;
+    #else
+    /* lazy: space is reserved, the registers are stored only if the ISR uses the FPU */
+    FPU->FPCCR |= (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+    #endif
+    __DSB();
+    __ISB();
   #endif
 
   /* Configure the Vector Table location add offset address ------------------*/
-#ifdef VECT_TAB_SRAM
+#if defined(VECT_TAB_RAM_COPY)
+  for(uint32_t i = 0U; i < VECT_TAB_ENTRIES; i++)
+  {
+    g_ramVectors[i] = g_pfnVectors[i];
+  }
+  __DSB();
+  SCB->VTOR = (uint32_t)g_ramVectors; /* Vector Table Relocation to the RAM copy */
+  __DSB();
+#elif defined(VECT_TAB_SRAM)
   SCB->VTOR = SRAM_BASE | VECT_TAB_OFFSET; /* Vector Table Relocation in Internal SRAM */
 #else
   SCB->VTOR = FLASH_BASE | VECT_TAB_OFFSET; /* Vector Table Relocation in Internal FLASH */
 #endif
 
-  /* 4 waitstates @170MHz */
-  FLASH->ACR |= 4;
+  /* Enable the DWT cycle counter, used to measure the clock recovery time */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+#if defined(FAST_BOOT)
+  const uint32_t deferClock = 1U;
+#else
+  /* a warm reset after a fault takes the fast path as well to minimize the downtime */
+  const uint32_t deferClock = SystemInit_IsWarmBoot();
+#endif
+
+  if(deferClock != 0U)
+  {
+    /* Keep running on HSI16 and branch to main immediately. RCC_IRQHandler
+       starts the PLL once HSE is ready and switches over once the PLL is locked.
+       A SysTick one-shot falls back to the PLL from HSI16 if HSE does not start. */
+    RCC->CICR = RCC_CICR_HSERDYC | RCC_CICR_PLLRDYC;
+    RCC->CIER |= RCC_CIER_HSERDYIE;
+    NVIC_EnableIRQ(RCC_IRQn);
+    RCC->CR |= RCC_CR_HSEON;
+
+    SystemClock_HsePending = 1U;
+    SysTick->LOAD = ((HSI_VALUE / 1000U) * HSE_STARTUP_TIMEOUT_MS) - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    return;
+  }
+
+  uint32_t timeout = HSE_STARTUP_TIMEOUT;
 
   /* Setup core clock to HSE */
   RCC->CR |= RCC_CR_HSEON;
-  while((RCC->CR & RCC_CR_HSERDY) == 0);	// wait until HSE is ready
+  while(((RCC->CR & RCC_CR_HSERDY) == 0) && (timeout > 0U))	// wait until HSE is ready
+  {
+    timeout--;
+  }
 
-  // switch system clock to HSE (SW = 2)
-  RCC->CFGR = 2;
+  if((RCC->CR & RCC_CR_HSERDY) != 0)
+  {
+    // switch system clock to HSE
+    RCC->CFGR = RCC_CFGR_SW_HSE;
+    SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSE);
+  }
+  else
+  {
+    // crystal failed to start => run the PLL from HSI16
+    RCC->CR &= ~RCC_CR_HSEON;
+    SystemClockStatus.hseStartupFailures++;
+    SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSI);
+  }
 
-  /* Now move on to switch to 170 MHz */
-  RCC->CFGR |= 0x00000080;		/* configure AHB prescaler to /2 => we should not do the switch in one step */
+  if(SystemClock_WaitPllLocked() != 0U)
+  {
+    SystemClock_SwitchToPll();
+  }
+}
+
+/**
+  * @brief  Completes the deferred clock bring-up started by SystemInit().
+  * @param  None
+  * @retval None
+  */
+void RCC_IRQHandler(void)
+{
+  uint32_t flags = RCC->CIFR;
+
+  RCC->CICR = flags;
+
+  if(((flags & RCC_CIFR_HSERDYF) != 0U) && (SystemClock_HsePending != 0U))
+  {
+    SystemClock_StopTimeout();
+    RCC->CIER &= ~RCC_CIER_HSERDYIE;
+    RCC->CIER |= RCC_CIER_PLLRDYIE;
+    SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSE);
+  }
+
+  if((flags & RCC_CIFR_PLLRDYF) != 0U)
+  {
+    RCC->CIER &= ~RCC_CIER_PLLRDYIE;
+    NVIC_DisableIRQ(RCC_IRQn);
+    SystemClock_SwitchToPll();
+  }
+}
+
+/**
+  * @brief  HSE start-up timeout of the deferred bring-up, called from SysTick_Handler.
+  *         Falls back to the PLL from HSI16 like the blocking path of SystemInit().
+  * @param  None
+  * @retval None
+  */
+void SystemClock_TickHandler(void)
+{
+  if(SystemClock_HsePending == 0U)
+  {
+    return;
+  }
+
+  /* same priority as RCC_IRQHandler: no preemption, but HSERDYF may be pending */
+  RCC->CIER &= ~RCC_CIER_HSERDYIE;
+  RCC->CICR = RCC_CICR_HSERDYC;
+  SystemClock_StopTimeout();
+
+  if((RCC->CR & RCC_CR_HSERDY) != 0U)
+  {
+    /* became ready at the deadline */
+    SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSE);
+  }
+  else
+  {
+    RCC->CR &= ~RCC_CR_HSEON;
+    SystemClockStatus.hseStartupFailures++;
+    SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSI);
+  }
+  RCC->CIER |= RCC_CIER_PLLRDYIE;
+}
+
+/**
+  * @brief  Hook telling SystemInit() that this reset was a warm reset of the
+  *         fault manager. Overridden by the fault component.
+  * @param  None
+  * @retval 1 on a warm reset, else 0
+  */
+__WEAK uint32_t SystemInit_IsWarmBoot(void)
+{
+  return 0U;
+}
+
+/**
+  * @brief  Hook called after the system clock has been changed. Components
+  *         caching clock frequencies override it to invalidate their cache.
+  * @param  None
+  * @retval None
+  */
+__WEAK void SystemCoreClockChanged(void)
+{
+}
+
+/**
+  * @brief  Handles an HSE failure detected by the clock security system.
+  * @param  None
+  * @retval None
+  */
+void SystemClock_CssHandler(void)
+{
+  uint32_t start = DWT->CYCCNT;
+  uint32_t cycles;
+
+  RCC->CICR = RCC_CICR_CSSC;
+  SystemClockStatus.cssEvents++;
+  SystemClockStatus.source = SYSCLK_SOURCE_HSI16;	// switched by hardware
+
+  SystemClock_StartPll(RCC_PLLCFGR_PLLSRC_HSI);
+  if(SystemClock_WaitPllLocked() != 0U)
+  {
+    SystemClock_SwitchToPll();
+  }
+  else
+  {
+    SystemCoreClockUpdate();
+    SystemCoreClockChanged();
+  }
+
+  cycles = DWT->CYCCNT - start;
+  SystemClockStatus.lastRecoveryCycles = cycles;
+  if(cycles > SystemClockStatus.maxRecoveryCycles)
+  {
+    SystemClockStatus.maxRecoveryCycles = cycles;
+  }
+}
+
+/**
+  * @brief  Configures the PLL for 170 MHz from HSE or HSI16 and enables it.
+  *         Does not wait for the PLL to lock.
+  * @param  pllsource RCC_PLLCFGR_PLLSRC_HSE or RCC_PLLCFGR_PLLSRC_HSI
+  * @retval None
+  */
+static void SystemClock_StartPll(uint32_t pllsource)
+{
+  uint32_t pllm = ((pllsource == RCC_PLLCFGR_PLLSRC_HSE) ? HSE_VALUE : HSI_VALUE) / PLL_INPUT_VALUE;
+  uint32_t timeout = PLL_LOCK_TIMEOUT;
 
   // Configure PLL
   RCC->CR &= ~RCC_CR_PLLON;					// disable PLL
-  while((RCC->CR & RCC_CR_PLLRDY) != 0);
+  while(((RCC->CR & RCC_CR_PLLRDY) != 0) && (timeout > 0U))
+  {
+    timeout--;
+  }
 
   // configure PLL
-  RCC->PLLCFGR = (0 << RCC_PLLCFGR_PLLR_Pos) | (85 << RCC_PLLCFGR_PLLN_Pos) | ((6-1) << RCC_PLLCFGR_PLLM_Pos) | (3 << RCC_PLLCFGR_PLLSRC_Pos);
+  RCC->PLLCFGR = (PLL_R_DIV2 << RCC_PLLCFGR_PLLR_Pos) | (PLL_N << RCC_PLLCFGR_PLLN_Pos) | ((pllm-1) << RCC_PLLCFGR_PLLM_Pos) | pllsource;
 
   // enable PLL
   RCC->CR |= RCC_CR_PLLON;
-  while((RCC->CR & RCC_CR_PLLRDY) == 0);
+}
+
+/**
+  * @brief  Waits for the PLL to lock, bounded by PLL_LOCK_TIMEOUT.
+  * @param  None
+  * @retval 0 if the PLL did not lock in time
+  */
+static uint32_t SystemClock_WaitPllLocked(void)
+{
+  uint32_t timeout = PLL_LOCK_TIMEOUT;
+
+  while(((RCC->CR & RCC_CR_PLLRDY) == 0) && (timeout > 0U))
+  {
+    timeout--;
+  }
+  return (RCC->CR & RCC_CR_PLLRDY);
+}
+
+/**
+  * @brief  Switches the system clock to the locked PLL (170 MHz).
+  * @param  None
+  * @retval None
+  */
+static void SystemClock_SwitchToPll(void)
+{
+  uint32_t	temp;
 
-  RCC->PLLCFGR |= (1 << RCC_PLLCFGR_PLLREN_Pos);	// enable PLL channel for system clock
+  /* 4 waitstates @170MHz, caches are disabled and reset while the latency changes */
+  FLASH->ACR &= ~(FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+  FLASH->ACR |= (FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+  FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+  FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLASH_ACR_LATENCY_4WS;
+  while((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_ACR_LATENCY_4WS);
+  /* enable ART accelerator according to build configuration */
+  FLASH->ACR |= FLASH_ACR_ACCEL_CONFIG;
+
+  /* Now move on to switch to 170 MHz */
+  RCC->CFGR |= RCC_CFGR_HPRE_DIV2;		/* configure AHB prescaler to /2 => we should not do the switch in one step */
+
+  RCC->PLLCFGR |= RCC_PLLCFGR_PLLREN;	// enable PLL channel for system clock
 
   // select PLL as system clock
-  RCC->CFGR |= 0x00000003;
+  RCC->CFGR |= RCC_CFGR_SW_PLL;
+  while((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL);
 
   // wait at least 1us
   for(temp = 1000;temp>0;temp--);
@@ -210,7 +503,34 @@ void SystemInit(void)
   PWR->CR5 &= ~PWR_CR5_R1MODE;
 
   // switch to high frequency
-  RCC->CFGR &= 0xFFFFFF0F;
+  RCC->CFGR &= ~RCC_CFGR_HPRE;
+
+  if((RCC->PLLCFGR & RCC_PLLCFGR_PLLSRC) == RCC_PLLCFGR_PLLSRC_HSE)
+  {
+    // supervise the crystal, a failure raises the NMI (see SystemClock_CssHandler)
+    RCC->CR |= RCC_CR_CSSON;
+    SystemClockStatus.source = SYSCLK_SOURCE_PLL_HSE;
+  }
+  else
+  {
+    SystemClockStatus.source = SYSCLK_SOURCE_PLL_HSI;
+  }
+
+  SystemCoreClockUpdate();
+  SystemCoreClockChanged();
+  BootProfile_Mark(BOOT_PHASE_CLOCK_READY);
+}
+
+/**
+  * @brief  Ends the HSE start-up one-shot of the deferred bring-up.
+  * @param  None
+  * @retval None
+  */
+static void SystemClock_StopTimeout(void)
+{
+  SystemClock_HsePending = 0U;
+  SysTick->CTRL = 0U;
+  SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
 }
 
 /**
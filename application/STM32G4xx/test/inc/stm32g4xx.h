@@ -0,0 +1,81 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+/*
+ * Host build of code on the CMSIS device header: the peripheral pointers the system code and the fault handling
+ * use are redirected to register blocks in host memory and the barrier instructions become compiler barriers.
+ * The test plays the part of the hardware, e.g. it sets HSERDY and raises HSERDYF before it calls
+ * RCC_IRQHandler(), or sets CFSR before it calls Fault_Handler().
+ */
+
+#include_next "stm32g4xx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern RCC_TypeDef      TestRcc;
+extern FLASH_TypeDef    TestFlash;
+extern PWR_TypeDef      TestPwr;
+extern SCB_Type         TestScb;
+extern SysTick_Type     TestSysTick;
+extern DWT_Type         TestDwt;
+extern CoreDebug_Type   TestCoreDebug;
+
+/* NVIC enable state of the external interrupts 0..31, set and cleared by NVIC_EnableIRQ()/NVIC_DisableIRQ() */
+extern uint32_t         TestNvicEnabled;
+
+void TestNvic_EnableIRQ(IRQn_Type irqn);
+void TestNvic_DisableIRQ(IRQn_Type irqn);
+
+/* Clears all register blocks and the NVIC enable state. In C, C++ can not assign the CMSIS structs (const members) */
+void TestRegisters_Reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef RCC
+#undef FLASH
+#undef PWR
+#undef SCB
+#undef SysTick
+#undef DWT
+#undef CoreDebug
+#undef NVIC_EnableIRQ
+#undef NVIC_DisableIRQ
+
+#define RCC                 (&TestRcc)
+#define FLASH               (&TestFlash)
+#define PWR                 (&TestPwr)
+#define SCB                 (&TestScb)
+#define SysTick             (&TestSysTick)
+#define DWT                 (&TestDwt)
+#define CoreDebug           (&TestCoreDebug)
+#define NVIC_EnableIRQ      TestNvic_EnableIRQ
+#define NVIC_DisableIRQ     TestNvic_DisableIRQ
+
+#define __DSB()             __asm volatile ("" ::: "memory")
+#define __ISB()             __asm volatile ("" ::: "memory")
+#define __DMB()             __asm volatile ("" ::: "memory")
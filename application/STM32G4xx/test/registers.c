@@ -0,0 +1,58 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/* Register blocks of inc/stm32g4xx.h, defined in C because the CMSIS structs have const (read-only) members */
+
+#include <string.h>
+
+#include "stm32g4xx.h"
+
+RCC_TypeDef     TestRcc;
+FLASH_TypeDef   TestFlash;
+PWR_TypeDef     TestPwr;
+SCB_Type        TestScb;
+SysTick_Type    TestSysTick;
+DWT_Type        TestDwt;
+CoreDebug_Type  TestCoreDebug;
+uint32_t        TestNvicEnabled;
+
+void TestNvic_EnableIRQ(IRQn_Type irqn)
+{
+  TestNvicEnabled |= (1UL << (uint32_t)irqn);
+}
+
+void TestNvic_DisableIRQ(IRQn_Type irqn)
+{
+  TestNvicEnabled &= ~(1UL << (uint32_t)irqn);
+}
+
+void TestRegisters_Reset(void)
+{
+  memset(&TestRcc, 0, sizeof(TestRcc));
+  memset(&TestFlash, 0, sizeof(TestFlash));
+  memset(&TestPwr, 0, sizeof(TestPwr));
+  memset(&TestScb, 0, sizeof(TestScb));
+  memset(&TestSysTick, 0, sizeof(TestSysTick));
+  memset(&TestDwt, 0, sizeof(TestDwt));
+  memset(&TestCoreDebug, 0, sizeof(TestCoreDebug));
+  TestNvicEnabled = 0U;
+}
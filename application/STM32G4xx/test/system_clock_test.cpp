@@ -0,0 +1,259 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "stm32g4xx.h"
+#include "system_clock.h"
+#include "unittest.h"
+
+extern "C" {
+
+void RCC_IRQHandler(void);
+
+// overrides the weak hook, the clock controller is not part of this test
+static uint32_t clockChanges;
+void SystemCoreClockChanged(void) {
+    clockChanges++;
+}
+
+// overrides the weak hook: a warm boot defers the bring-up like FAST_BOOT, a cold boot takes the blocking path
+static uint32_t warmBoot;
+uint32_t SystemInit_IsWarmBoot(void) {
+    return (warmBoot);
+}
+
+}
+
+namespace {
+
+constexpr uint32_t PllFromHse = (85U << RCC_PLLCFGR_PLLN_Pos) | (5U << RCC_PLLCFGR_PLLM_Pos) | RCC_PLLCFGR_PLLSRC_HSE;
+constexpr uint32_t PllFromHsi = (85U << RCC_PLLCFGR_PLLN_Pos) | (3U << RCC_PLLCFGR_PLLM_Pos) | RCC_PLLCFGR_PLLSRC_HSI;
+constexpr uint32_t HseTimeoutTicks = 16000U * 100U;     // HSE_STARTUP_TIMEOUT_MS on HSI16
+
+void setUp(void) {
+    TestRegisters_Reset();
+    TestRcc.CFGR = RCC_CFGR_SWS_HSI;
+    SystemClockStatus.source = SYSCLK_SOURCE_HSI16;
+    SystemClockStatus.hseStartupFailures = 0U;
+    SystemClockStatus.cssEvents = 0U;
+    SystemClockStatus.lastRecoveryCycles = 0U;
+    SystemClockStatus.maxRecoveryCycles = 0U;
+    SystemCoreClock = 16000000U;
+    clockChanges = 0U;
+    warmBoot = 1U;
+}
+
+/// The polling code sees the PLL locked and the system clock switch taken effect, as soon as it looks
+void pllLocksWhenPolled(void) {
+    TestRcc.CR |= RCC_CR_PLLRDY;
+    TestRcc.CFGR |= RCC_CFGR_SWS_PLL;
+}
+
+/// Clock security system: the crystal stops, the hardware switches SYSCLK to HSI16, stops the PLL and raises CSSF
+void loseHse(void) {
+    TestRcc.CR &= ~(RCC_CR_HSERDY | RCC_CR_HSEON | RCC_CR_PLLRDY | RCC_CR_PLLON);
+    TestRcc.CFGR = (TestRcc.CFGR & ~(RCC_CFGR_SW | RCC_CFGR_SWS)) | RCC_CFGR_SW_HSI | RCC_CFGR_SWS_HSI;
+    TestRcc.CIFR = RCC_CIFR_CSSF;
+}
+
+/// PLL locks and the system clock switch takes effect, as the hardware would report it
+void lockPll(void) {
+    TestRcc.CR |= RCC_CR_PLLRDY;
+    TestRcc.CFGR |= RCC_CFGR_SWS_PLL;
+    TestRcc.CIFR = RCC_CIFR_PLLRDYF;
+    RCC_IRQHandler();
+}
+
+/// Deferred bring-up on the crystal, ends with the PLL on HSE and CSS on
+void runOnHse(void) {
+    SystemInit();
+    TestRcc.CR |= RCC_CR_HSERDY;
+    TestRcc.CIFR = RCC_CIFR_HSERDYF;
+    RCC_IRQHandler();
+    lockPll();
+}
+
+void testDeferredStartArmsTimeout(void) {
+    setUp();
+    SystemInit();
+
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) != 0U);
+    TEST_CHECK((TestRcc.CR & RCC_CR_PLLON) == 0U);
+    TEST_EQUAL(RCC_CIER_HSERDYIE, TestRcc.CIER);
+    TEST_EQUAL(1UL << RCC_IRQn, TestNvicEnabled);
+    TEST_EQUAL(HseTimeoutTicks - 1U, TestSysTick.LOAD);
+    TEST_EQUAL(SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk, TestSysTick.CTRL);
+    TEST_EQUAL(16000000U, SystemCoreClock);         // main() starts on HSI16
+    TEST_EQUAL(SYSCLK_SOURCE_HSI16, SystemClockStatus.source);
+}
+
+void testHseTimeoutFallsBackToHsi(void) {
+    setUp();
+    SystemInit();
+    SystemClock_TickHandler();                      // HSERDY never came
+
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) == 0U);
+    TEST_CHECK((TestRcc.CR & RCC_CR_PLLON) != 0U);
+    TEST_EQUAL(PllFromHsi, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CIER_PLLRDYIE, TestRcc.CIER);
+    TEST_EQUAL(1U, SystemClockStatus.hseStartupFailures);
+    TEST_EQUAL(0U, TestSysTick.CTRL);               // one-shot stopped
+    TEST_EQUAL(SCB_ICSR_PENDSTCLR_Msk, TestScb.ICSR);
+
+    lockPll();
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSI, SystemClockStatus.source);
+    TEST_EQUAL(170000000U, SystemCoreClock);
+    TEST_EQUAL(FLASH_ACR_LATENCY_4WS, TestFlash.ACR & FLASH_ACR_LATENCY);
+    TEST_CHECK((TestRcc.CR & RCC_CR_CSSON) == 0U);  // nothing to supervise
+    TEST_EQUAL(0U, TestNvicEnabled);
+    TEST_EQUAL(1U, clockChanges);
+
+    // a late HSE and a stale tick change nothing
+    TestRcc.CR |= RCC_CR_HSERDY;
+    TestRcc.CIFR = RCC_CIFR_HSERDYF;
+    RCC_IRQHandler();
+    SystemClock_TickHandler();
+    TEST_EQUAL(PllFromHsi | RCC_PLLCFGR_PLLREN, TestRcc.PLLCFGR);
+    TEST_EQUAL(1U, SystemClockStatus.hseStartupFailures);
+    TEST_EQUAL(1U, clockChanges);
+}
+
+void testHseReadyBeforeTimeout(void) {
+    setUp();
+    SystemInit();
+    TestRcc.CR |= RCC_CR_HSERDY;
+    TestRcc.CIFR = RCC_CIFR_HSERDYF;
+    RCC_IRQHandler();
+
+    TEST_EQUAL(0U, TestSysTick.CTRL);
+    TEST_EQUAL(PllFromHse, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CIER_PLLRDYIE, TestRcc.CIER);
+
+    SystemClock_TickHandler();                      // tick that was already pending
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) != 0U);
+    TEST_EQUAL(0U, SystemClockStatus.hseStartupFailures);
+
+    lockPll();
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSE, SystemClockStatus.source);
+    TEST_EQUAL(170000000U, SystemCoreClock);
+    TEST_CHECK((TestRcc.CR & RCC_CR_CSSON) != 0U);  // crystal supervised from now on
+    TEST_EQUAL(1U, clockChanges);
+}
+
+void testHseReadyAtDeadline(void) {
+    setUp();
+    SystemInit();
+    TestRcc.CR |= RCC_CR_HSERDY;                    // HSERDYF not handled yet
+    SystemClock_TickHandler();
+
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) != 0U);
+    TEST_EQUAL(PllFromHse, TestRcc.PLLCFGR);
+    TEST_EQUAL(0U, SystemClockStatus.hseStartupFailures);
+    TEST_EQUAL(RCC_CIER_PLLRDYIE, TestRcc.CIER);
+    TEST_EQUAL(RCC_CICR_HSERDYC, TestRcc.CICR);     // pending HSERDYF dropped
+
+    lockPll();
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSE, SystemClockStatus.source);
+}
+
+void testBlockingHseTimeout(void) {
+    setUp();
+    warmBoot = 0U;
+    pllLocksWhenPolled();
+    SystemInit();                                   // HSERDY never comes
+
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) == 0U);
+    TEST_EQUAL(1U, SystemClockStatus.hseStartupFailures);
+    TEST_EQUAL(PllFromHsi | RCC_PLLCFGR_PLLREN, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CFGR_SW_PLL, TestRcc.CFGR & RCC_CFGR_SW);
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSI, SystemClockStatus.source);
+    TEST_EQUAL(170000000U, SystemCoreClock);
+    TEST_CHECK((TestRcc.CR & RCC_CR_CSSON) == 0U);
+    TEST_EQUAL(0U, TestSysTick.CTRL);               // no one-shot on the blocking path
+    TEST_EQUAL(0U, TestNvicEnabled);
+    TEST_EQUAL(1U, clockChanges);
+}
+
+void testBlockingHseTimeoutPllUnlocked(void) {
+    setUp();
+    warmBoot = 0U;
+    SystemInit();                                   // neither HSERDY nor PLLRDY come
+
+    TEST_CHECK((TestRcc.CR & RCC_CR_HSEON) == 0U);
+    TEST_EQUAL(1U, SystemClockStatus.hseStartupFailures);
+    TEST_EQUAL(PllFromHsi, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CFGR_SWS_HSI, TestRcc.CFGR);     // still on HSI16
+    TEST_EQUAL(SYSCLK_SOURCE_HSI16, SystemClockStatus.source);
+    TEST_EQUAL(16000000U, SystemCoreClock);
+    TEST_EQUAL(0U, clockChanges);
+}
+
+void testCssSwitchesPllToHsi(void) {
+    setUp();
+    runOnHse();
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSE, SystemClockStatus.source);
+    TEST_CHECK((TestRcc.CR & RCC_CR_CSSON) != 0U);
+    TEST_EQUAL(1U, clockChanges);
+
+    loseHse();
+    pllLocksWhenPolled();
+    SystemClock_CssHandler();                       // NMI_Handler, CSSF set
+
+    TEST_EQUAL(RCC_CICR_CSSC, TestRcc.CICR);
+    TEST_EQUAL(1U, SystemClockStatus.cssEvents);
+    TEST_EQUAL(RCC_PLLCFGR_PLLSRC_HSI, TestRcc.PLLCFGR & RCC_PLLCFGR_PLLSRC);
+    TEST_EQUAL(PllFromHsi | RCC_PLLCFGR_PLLREN, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CFGR_SW_PLL, TestRcc.CFGR & RCC_CFGR_SW);
+    TEST_EQUAL(SYSCLK_SOURCE_PLL_HSI, SystemClockStatus.source);
+    TEST_EQUAL(170000000U, SystemCoreClock);
+    TEST_EQUAL(2U, clockChanges);                   // listeners ran for the new source
+    TEST_EQUAL(0U, SystemClockStatus.hseStartupFailures);
+}
+
+void testCssWithoutPllLock(void) {
+    setUp();
+    runOnHse();
+
+    loseHse();                                      // PLL does not lock on HSI16 either
+    SystemClock_CssHandler();
+
+    TEST_EQUAL(1U, SystemClockStatus.cssEvents);
+    TEST_EQUAL(PllFromHsi, TestRcc.PLLCFGR);
+    TEST_EQUAL(RCC_CFGR_SW_HSI, TestRcc.CFGR & RCC_CFGR_SW);
+    TEST_EQUAL(SYSCLK_SOURCE_HSI16, SystemClockStatus.source);
+    TEST_EQUAL(16000000U, SystemCoreClock);
+    TEST_EQUAL(2U, clockChanges);
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"deferred start arms the HSE timeout", testDeferredStartArmsTimeout},
+        {"HSE timeout falls back to the HSI16 PLL", testHseTimeoutFallsBackToHsi},
+        {"HSE ready before the timeout", testHseReadyBeforeTimeout},
+        {"HSE ready at the deadline", testHseReadyAtDeadline},
+        {"blocking HSE timeout falls back to the HSI16 PLL", testBlockingHseTimeout},
+        {"blocking HSE timeout without PLL lock stays on HSI16", testBlockingHseTimeoutPllUnlocked},
+        {"CSS switches the PLL to HSI16", testCssSwitchesPllToHsi},
+        {"CSS without PLL lock stays on HSI16", testCssWithoutPllLock},
+    }));
+}
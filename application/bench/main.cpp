@@ -0,0 +1,357 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/*
+ * Benchmark firmware of the drivers and kernels, run by tools/bench.py under the Renode emulator.
+ *
+ * Every kernel is an extern "C" function bench_<name>() with a fixed amount of work. run() passes its address to
+ * the Bench_Start() and Bench_Stop() markers, the emulator hooks these and records the number of executed
+ * instructions in between; the runner resolves the address to the kernel name with the symbol table.
+ * bench_empty() measures the marker overhead, which is subtracted from all other kernels.
+ *
+ * Bench_Stop() also gets the DWT cycle count of the kernel. Wait states and exception stacking only show up in
+ * the cycles, e.g. flash against CCMSRAM code, they are reported next to the instructions where the core counts
+ * them (the Renode platform has no DWT, the cycles read 0 there).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "crashdump.h"
+#include "dio.h"
+#include "memmap.h"
+#include "pool.h"
+#include "scratcharena.h"
+#include "stackmon.h"
+#include "stm32g4xx.h"
+#include "tlsf.h"
+
+using Kernel_t = void (*)(void);
+
+extern "C" {
+
+// Markers hooked by the emulator, the kernel address is passed in r0
+__attribute__((noinline, used)) void Bench_Start(Kernel_t kernel) {
+    __asm volatile("" : : "r"(kernel) : "memory");
+}
+
+__attribute__((noinline, used)) void Bench_Stop(Kernel_t kernel, uint32_t cycles) {
+    __asm volatile("" : : "r"(kernel), "r"(cycles) : "memory");
+}
+
+__attribute__((noinline, used)) void Bench_Done(void) {
+    __asm volatile("" : : : "memory");
+}
+
+}
+
+namespace {
+
+constexpr uint32_t NumOfIterations = 64U;
+
+mcal::GPIO_Port_t ramPort;                      // register set in RAM, the emulator does not model the GPIOs
+alignas(8) uint8_t tlsfArena[8192];
+mem::Tlsf tlsf;
+
+struct Message_t {
+    uint32_t id;
+    uint8_t payload[28];
+};
+mem::Pool<Message_t, 16U> messagePool;
+
+mem::StaticScratchArena<1024U> scratch;
+uint8_t crcData[256];
+volatile uint32_t sink;                         // keeps results alive
+
+/// FIR filter of a control loop, code and data once in flash/SRAM and once in CCMSRAM
+constexpr uint32_t NumOfTaps = 16U;
+constexpr uint32_t NumOfSamples = 64U;
+#define FIR_COEFFICIENTS { 0.0060f, 0.0116f, 0.0269f, 0.0497f, 0.0759f, 0.1005f, 0.1183f, 0.1261f, \
+                           0.1261f, 0.1183f, 0.1005f, 0.0759f, 0.0497f, 0.0269f, 0.0116f, 0.0060f }
+const float firCoefficients[NumOfTaps] = FIR_COEFFICIENTS;
+float firSamples[NumOfSamples + NumOfTaps];
+CCMRAM_DATA float ccmFirCoefficients[NumOfTaps] = FIR_COEFFICIENTS;
+CCMRAM_BSS float ccmFirSamples[NumOfSamples + NumOfTaps];
+volatile float floatSink;
+
+__attribute__((always_inline)) inline void fir(const float* coefficients, const float* samples) {
+    float sum = 0.0f;
+    for(uint32_t n = 0U; n < NumOfSamples; n++) {
+        float y = 0.0f;
+        for(uint32_t k = 0U; k < NumOfTaps; k++) {
+            y += coefficients[k] * samples[n + k];
+        }
+        sum += y;
+    }
+    floatSink = sum;
+}
+
+/// Branchy code: byte stream parser of a framed protocol (0x7E, length, payload, checksum)
+enum class ParserState_t : uint8_t { Sync, Length, Payload, Checksum };
+
+__attribute__((always_inline)) inline void parse(const uint8_t* data, uint32_t size) {
+    ParserState_t state = ParserState_t::Sync;
+    uint32_t remaining = 0U;
+    uint8_t checksum = 0U;
+    uint32_t frames = 0U;
+    for(uint32_t i = 0U; i < size; i++) {
+        const uint8_t byte = data[i];
+        switch(state) {
+        case ParserState_t::Sync:
+            if(byte == 0x7EU) {
+                state = ParserState_t::Length;
+            }
+            break;
+        case ParserState_t::Length:
+            remaining = byte & 0x0FU;
+            checksum = 0U;
+            state = (remaining != 0U) ? ParserState_t::Payload : ParserState_t::Sync;
+            break;
+        case ParserState_t::Payload:
+            checksum = static_cast<uint8_t>(checksum + byte);
+            if(--remaining == 0U) {
+                state = ParserState_t::Checksum;
+            }
+            break;
+        default:
+            frames += (checksum == byte) ? 1U : 0U;
+            state = ParserState_t::Sync;
+            break;
+        }
+    }
+    sink = frames;
+}
+
+/// Table lookups: data dependent reads of a bit reversal table, in flash and in CCMSRAM
+struct ByteTable_t {
+    uint8_t values[256];
+};
+
+constexpr ByteTable_t makeReverseTable(void) {
+    ByteTable_t table{};
+    for(uint32_t i = 0U; i < 256U; i++) {
+        uint32_t reversed = 0U;
+        for(uint32_t bit = 0U; bit < 8U; bit++) {
+            reversed |= ((i >> bit) & 1U) << (7U - bit);
+        }
+        table.values[i] = static_cast<uint8_t>(reversed);
+    }
+    return (table);
+}
+
+const ByteTable_t reverseTable = makeReverseTable();
+CCMRAM_DATA ByteTable_t ccmReverseTable = makeReverseTable();
+
+__attribute__((always_inline)) inline void lookup(const ByteTable_t& table, const uint8_t* data, uint32_t size) {
+    uint32_t value = 0U;
+    for(uint32_t i = 0U; i < size; i++) {
+        value = (value << 3) ^ table.values[(data[i] ^ value) & 0xFFU];
+    }
+    sink = value;
+}
+
+/// The bench interrupt (FMAC is unused), the kernels pend it and wait for its return
+constexpr IRQn_Type BenchIrq = FMAC_IRQn;
+volatile bool irqUsesFpu = false;
+volatile float irqFloatSink;
+
+__attribute__((always_inline)) inline void pendBenchIrq(void) {
+    NVIC_SetPendingIRQ(BenchIrq);
+    __DSB();
+    __ISB();
+}
+
+void run(Kernel_t kernel) {
+    Bench_Start(kernel);
+    const uint32_t start = DWT->CYCCNT;
+    kernel();
+    const uint32_t cycles = DWT->CYCCNT - start;
+    Bench_Stop(kernel, cycles);
+}
+
+}   // namespace
+
+extern "C" {
+
+__attribute__((noinline)) void bench_empty(void) {
+}
+
+__attribute__((noinline)) void bench_dio_set_reset(void) {
+    mcal::DioPin pin(ramPort, mcal::IDioPin::Pin5);
+    for(uint32_t i = 0U; i < NumOfIterations; i++) {
+        pin.set();
+        pin.reset();
+    }
+}
+
+__attribute__((noinline)) void bench_dio_read(void) {
+    mcal::DioPin pin(ramPort, mcal::IDioPin::Pin5);
+    uint32_t set = 0U;
+    for(uint32_t i = 0U; i < NumOfIterations; i++) {
+        set += (pin.read() == mcal::IDioPin::PinState_t::SET) ? 1U : 0U;
+    }
+    sink = set;
+}
+
+__attribute__((noinline)) void bench_tlsf_alloc_release(void) {
+    static constexpr std::size_t Sizes[] = {16U, 40U, 100U, 24U, 300U, 64U, 8U, 180U};
+    void* blocks[8];
+    for(uint32_t i = 0U; i < (NumOfIterations / 8U); i++) {
+        for(uint32_t k = 0U; k < 8U; k++) {
+            blocks[k] = tlsf.allocate(Sizes[(i + k) % 8U]);
+        }
+        for(uint32_t k = 0U; k < 8U; k += 2U) {
+            tlsf.release(blocks[k]);
+        }
+        for(uint32_t k = 1U; k < 8U; k += 2U) {
+            tlsf.release(blocks[k]);
+        }
+    }
+}
+
+__attribute__((noinline)) void bench_pool_create_destroy(void) {
+    Message_t* messages[8];
+    for(uint32_t i = 0U; i < (NumOfIterations / 8U); i++) {
+        for(uint32_t k = 0U; k < 8U; k++) {
+            messages[k] = messagePool.construct();
+        }
+        for(uint32_t k = 0U; k < 8U; k++) {
+            messagePool.destroy(messages[k]);
+        }
+    }
+}
+
+__attribute__((noinline)) void bench_scratch_arena(void) {
+    for(uint32_t i = 0U; i < (NumOfIterations / 8U); i++) {
+        const mem::ScratchArena::Scope_t scope(scratch);
+        for(uint32_t k = 0U; k < 8U; k++) {
+            sink = reinterpret_cast<uintptr_t>(scratch.allocate<uint32_t>(k + 1U));
+        }
+    }
+}
+
+__attribute__((noinline)) void bench_crc32(void) {
+    sink = diag::CrashDump::crc32(crcData, sizeof(crcData));
+}
+
+__attribute__((noinline)) void bench_stackmon_scan(void) {
+    sink = diag::StackMonitor::scan();
+}
+
+/// Flash against CCMSRAM kernels: same instructions in both placements, only the cycles differ. The flash variants
+/// depend on the ART accelerator setting of the build (FLASH_ACCEL).
+__attribute__((noinline)) void bench_parser_flash(void) {
+    parse(crcData, sizeof(crcData));
+}
+
+CCMRAM_FUNC void bench_parser_ccmram(void) {
+    parse(crcData, sizeof(crcData));
+}
+
+__attribute__((noinline)) void bench_table_flash(void) {
+    lookup(reverseTable, crcData, sizeof(crcData));
+}
+
+CCMRAM_FUNC void bench_table_ccmram(void) {
+    lookup(ccmReverseTable, crcData, sizeof(crcData));
+}
+
+__attribute__((noinline)) void bench_fir_flash(void) {
+    fir(firCoefficients, firSamples);
+}
+
+CCMRAM_FUNC void bench_fir_ccmram(void) {
+    fir(ccmFirCoefficients, ccmFirSamples);
+}
+
+void FMAC_IRQHandler(void) {
+    if(irqUsesFpu) {
+        irqFloatSink = irqFloatSink * 0.5f;
+    }
+}
+
+/// Interrupt round trip (entry and exit stacking) without an active FP context: FPCA is cleared first, the
+/// bench itself has run FP code before
+__attribute__((noinline)) void bench_irq_entry(void) {
+    __set_CONTROL(__get_CONTROL() & ~CONTROL_FPCA_Msk);
+    __ISB();
+    pendBenchIrq();
+}
+
+/// Interrupt round trip with an active FP context: LAZY reserves the FP frame, EAGER stacks it, NONE ignores it
+__attribute__((noinline)) void bench_irq_entry_fp_context(void) {
+    floatSink = floatSink + 1.0f;
+    pendBenchIrq();
+}
+
+#if !defined(FPU_CONTEXT_NONE)
+/// Interrupt round trip with an active FP context and an ISR that uses the FPU: LAZY stacks on its first FP instruction
+__attribute__((noinline)) void bench_irq_entry_fp_isr(void) {
+    irqUsesFpu = true;
+    floatSink = floatSink + 1.0f;
+    pendBenchIrq();
+    irqUsesFpu = false;
+}
+#endif
+
+}
+
+int main(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    tlsf.addArena(tlsfArena, sizeof(tlsfArena));
+    for(uint32_t i = 0U; i < (NumOfSamples + NumOfTaps); i++) {
+        firSamples[i] = static_cast<float>(i % 7U) - 3.0f;
+        ccmFirSamples[i] = firSamples[i];
+    }
+    for(std::size_t i = 0U; i < sizeof(crcData); i++) {
+        crcData[i] = static_cast<uint8_t>(i * 7U);
+    }
+    NVIC_EnableIRQ(BenchIrq);
+
+    run(bench_empty);
+    run(bench_dio_set_reset);
+    run(bench_dio_read);
+    run(bench_tlsf_alloc_release);
+    run(bench_pool_create_destroy);
+    run(bench_scratch_arena);
+    run(bench_crc32);
+    run(bench_stackmon_scan);
+    run(bench_parser_flash);
+    run(bench_parser_ccmram);
+    run(bench_table_flash);
+    run(bench_table_ccmram);
+    run(bench_fir_flash);
+    run(bench_fir_ccmram);
+    run(bench_irq_entry);
+    run(bench_irq_entry_fp_context);
+#if !defined(FPU_CONTEXT_NONE)
+    run(bench_irq_entry_fp_isr);
+#endif
+    Bench_Done();
+
+    for(;;) {
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#include "BSP_setup.h"
+#include "clockgate.h"
+#include "stm32g474xx_regs.h"
+
+using namespace mcal::stm32g4;
+using mcal::ClockGate;
+
+static constexpr uint32_t GpioModeOutput = 1U;		// MODER: general purpose output
+
+void BSP_HWSetup(void)  {
+	ClockGate::acquire(ClockGate::Peripheral_t::GpioA);
+	ClockGate::acquire(ClockGate::Peripheral_t::GpioB);
+	ClockGate::acquire(ClockGate::Peripheral_t::I2c1);
+	Gpioa::Moder::write(Gpioa::Moder::Mode5::value<GpioModeOutput>());	// LD2 as output, all other pins at reset
+	Gpioa::Bsrr::write(Gpioa::Bsrr::Bs5::set());						// LD2 on
+}
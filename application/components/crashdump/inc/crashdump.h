@@ -0,0 +1,119 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace diag {
+
+/**
+ * @brief Crash record that survives a reset.
+ * 
+ * The fault handlers store the fault state into a record in the .noinit section, protected by a magic
+ * number and a CRC-32. After the following reset the application takes the record (copy and clear).
+ * The record can be decoded and symbolized on the host with tools/crashdump.py.
+ */
+class CrashDump {
+public:
+    static constexpr uint32_t Magic             = 0xDEADC0DEU;
+    static constexpr uint32_t Version           = 1U;
+    static constexpr uint32_t NumOfStackWords   = 32U;      ///< Stack words saved above the exception frame
+    static constexpr uint32_t NumOfTraceEvents  = 16U;      ///< Must be a power of two
+
+    /// Layout is decoded by tools/crashdump.py, update the script together with this struct
+    struct Record_t {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t r0;                ///< Exception frame stacked by the CPU
+        uint32_t r1;
+        uint32_t r2;
+        uint32_t r3;
+        uint32_t r12;
+        uint32_t lr;
+        uint32_t pc;
+        uint32_t xpsr;
+        uint32_t excReturn;         ///< EXC_RETURN of the fault handler
+        uint32_t sp;                ///< Stack pointer at the time of the fault (frame address)
+        uint32_t ipsr;              ///< Active exception number of the fault handler
+        uint32_t cfsr;
+        uint32_t hfsr;
+        uint32_t mmfar;
+        uint32_t bfar;
+        uint32_t numOfStackWords;   ///< Valid entries in stack[]
+        uint32_t stack[NumOfStackWords];
+        uint32_t traceHead;         ///< Total number of trace events recorded, trace[(traceHead-1) % N] is the latest
+        uint32_t trace[NumOfTraceEvents];
+        uint32_t crc;               ///< CRC-32 over all previous members
+    };
+
+    CrashDump(void) = delete;
+
+    /**
+     * @brief Records an application trace event. The last NumOfTraceEvents events are part of a crash record.
+     * 
+     * Can be called from threads and ISRs: the slot is claimed with an atomic increment of the head (LDREX/STREX),
+     * so an interrupting event takes the next slot instead of overwriting this one.
+     */
+    static void trace(uint32_t event) {
+        const uint32_t head = __atomic_fetch_add(&_traceHead, 1U, __ATOMIC_RELAXED);
+        _trace[head & (NumOfTraceEvents - 1U)] = event;
+    }
+
+    /**
+     * @brief Returns true if a valid record from a previous fault is present.
+     */
+    static bool isValid(void);
+
+    /**
+     * @brief Copies a valid record to the given buffer and clears it.
+     * 
+     * @return false if there is no valid record
+     */
+    static bool take(Record_t& record);
+
+    /**
+     * @brief Invalidates the stored record.
+     */
+    static void clear(void);
+
+    /**
+     * @brief Captures the fault state. Called by the fault handlers with the exception frame.
+     */
+    static void capture(const uint32_t* frame, uint32_t excReturn);
+
+    static uint32_t crc32(const void* data, uint32_t size);
+
+private:
+    static inline uint32_t _trace[NumOfTraceEvents]{};
+    static inline uint32_t _traceHead{0U};
+};
+
+static_assert((CrashDump::NumOfTraceEvents & (CrashDump::NumOfTraceEvents - 1U)) == 0U, "NumOfTraceEvents must be a power of two");
+
+}   // namespace diag
+
+/**
+ * @brief Fault handler for faults that are not recovered, called by the fault manager with the exception frame.
+ * Captures the crash record and resets the MCU (or stops at a breakpoint if a debugger is attached).
+ */
+extern "C" void CrashDump_FaultHandler(const uint32_t* frame, uint32_t excReturn);
@@ -0,0 +1,140 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "crashdump.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#include "stm32g4xx.h"
+#include "memmap.h"
+
+extern uint32_t _estack;        // top of the main stack, defined by the linker script
+
+NOINIT diag::CrashDump::Record_t g_crashRecord;     // survives resets, referenced by name in tools/crashdump.py
+
+namespace {
+
+constexpr uint32_t RamStart = SRAM1_BASE;
+
+}   // anonymous namespace
+
+namespace diag {
+
+uint32_t CrashDump::crc32(const void* data, uint32_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for(uint32_t i = 0U; i < size; i++) {
+        crc ^= bytes[i];
+        for(uint8_t bit = 0U; bit < 8U; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return (~crc);
+}
+
+bool CrashDump::isValid(void) {
+    return ((g_crashRecord.magic == Magic) &&
+            (g_crashRecord.version == Version) &&
+            (g_crashRecord.crc == crc32(&g_crashRecord, offsetof(Record_t, crc))));
+}
+
+bool CrashDump::take(Record_t& record) {
+    if(!isValid()) {
+        clear();
+        return (false);
+    }
+    record = g_crashRecord;
+    clear();
+    return (true);
+}
+
+void CrashDump::clear(void) {
+    g_crashRecord.magic = 0U;
+}
+
+COLD_FUNC void CrashDump::capture(const uint32_t* frame, uint32_t excReturn) {
+    Record_t& record = g_crashRecord;
+    const uint32_t frameAddress = reinterpret_cast<uintptr_t>(frame);
+    const uint32_t stackTop = reinterpret_cast<uintptr_t>(&_estack);
+    const uint32_t cfsr = SCB->CFSR;
+    // a failed exception entry (e.g. into the MPU stack guard) leaves no readable frame
+    const bool stackingFailed = (cfsr & (SCB_CFSR_MSTKERR_Msk | SCB_CFSR_STKERR_Msk)) != 0U;
+    // EXC_RETURN bit 4 cleared: extended frame with S0-S15, FPSCR and alignment word
+    const uint32_t frameBytes = ((excReturn & 0x10U) == 0U) ? 104U : 32U;
+    const bool frameValid = !stackingFailed && (frameAddress >= RamStart) && ((frameAddress + frameBytes) <= stackTop);
+
+    record.magic        = Magic;
+    record.version      = Version;
+    record.excReturn    = excReturn;
+    record.sp           = frameAddress;
+    record.ipsr         = __get_IPSR();
+    record.cfsr         = cfsr;
+    record.hfsr         = SCB->HFSR;
+    record.mmfar        = SCB->MMFAR;
+    record.bfar         = SCB->BFAR;
+
+    if(frameValid) {
+        record.r0   = frame[0];
+        record.r1   = frame[1];
+        record.r2   = frame[2];
+        record.r3   = frame[3];
+        record.r12  = frame[4];
+        record.lr   = frame[5];
+        record.pc   = frame[6];
+        record.xpsr = frame[7];
+
+        // bounded snapshot of the stack above the exception frame
+        const uint32_t* stack = frame + (frameBytes / sizeof(uint32_t));
+        uint32_t available = (stackTop - (frameAddress + frameBytes)) / sizeof(uint32_t);
+        record.numOfStackWords = (available < NumOfStackWords) ? available : NumOfStackWords;
+        for(uint32_t i = 0U; i < record.numOfStackWords; i++) {
+            record.stack[i] = stack[i];
+        }
+    } else {
+        // stack pointer is corrupt or stacking failed (stack overflow), the frame can not be read
+        record.r0 = record.r1 = record.r2 = record.r3 = record.r12 = 0U;
+        record.lr = record.pc = record.xpsr = 0U;
+        record.numOfStackWords = 0U;
+    }
+
+    record.traceHead = _traceHead;
+    for(uint32_t i = 0U; i < NumOfTraceEvents; i++) {
+        record.trace[i] = _trace[i];
+    }
+
+    record.crc = crc32(&record, offsetof(Record_t, crc));
+}
+
+}   // namespace diag
+
+// Kept with LTO: fault handlers outside of the LTO partition (assembly, fault component) branch to it
+extern "C" COLD_FUNC __attribute__((used)) void CrashDump_FaultHandler(const uint32_t* frame, uint32_t excReturn) {
+    diag::CrashDump::capture(frame, excReturn);
+    __DSB();
+
+    if((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0U) {
+        __BKPT(0);
+        for(;;) {}
+    }
+    NVIC_SystemReset();
+}
@@ -0,0 +1,222 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace diag {
+
+/**
+ * @brief Fault classification, recording and recovery.
+ * 
+ * The fault handlers pass every MemManage, BusFault, UsageFault and HardFault to handle(). The fault is classified
+ * from CFSR/HFSR and counted. A fault in thread mode inside run() with a precise address and a module within its
+ * restart budget is recovered: the exception returns into the resume point of run(), which calls the restart
+ * function of the module and returns false. All other faults are captured by CrashDump and end in a warm reset.
+ * After a warm reset SystemInit() brings up the clock asynchronously like FAST_BOOT and isWarmBoot() lets the
+ * application skip its slow init paths.
+ *
+ * classify() and decide() have no hardware dependencies.
+ */
+class FaultManager {
+public:
+    enum class Class_t : uint8_t {
+        None,
+        StackError,             ///< Stacking or unstacking failed (MSTKERR, MUNSTKERR, STKERR, UNSTKERR), e.g. overflow
+        MemoryAccess,           ///< MPU violation (DACCVIOL, IACCVIOL, MLSPERR)
+        BusError,               ///< Precise data or instruction bus error (PRECISERR, IBUSERR, LSPERR)
+        ImpreciseBusError,      ///< Buffered write failed, the faulting instruction is unknown (IMPRECISERR)
+        InvalidInstruction,     ///< UNDEFINSTR, INVSTATE, INVPC, NOCP
+        DivideByZero,           ///< DIVBYZERO (only with CCR.DIV_0_TRP)
+        Unaligned,              ///< UNALIGNED (only with CCR.UNALIGN_TRP or multiple load/store)
+        VectorFetch,            ///< Bus error on the vector table read (HFSR.VECTTBL)
+        Unknown                 ///< HardFault without a fault status bit, e.g. a breakpoint without debugger
+    };
+
+    enum class Action_t : uint8_t {
+        Recover,
+        WarmReset
+    };
+
+    struct Info_t {
+        Class_t cls;
+        bool addressValid;      ///< MMFAR or BFAR holds the faulting data address
+        uint32_t address;
+    };
+
+    /// A restartable part of the application, e.g. a task or a module of the main loop
+    struct Module_t {
+        const char* name;
+        void (*restart)(void);  ///< Brings the module into a defined state after a fault, may be nullptr
+        uint8_t maxRestarts;    ///< Faults handled by restart() before a warm reset
+        uint8_t numOfRestarts;
+    };
+
+    /// Fault statistics, kept in .noinit across warm resets
+    struct Stats_t {
+        uint32_t magic;
+        uint32_t numOfRecoveries;
+        uint32_t numOfWarmResets;
+        Class_t lastClass;
+        uint32_t lastPc;
+        uint32_t lastAddress;
+        const char* lastModule; ///< nullptr if the fault was not inside run()
+    };
+
+    // Configurable Fault Status Register bits (ARMv7-M), checked against CMSIS in fault.cpp
+    static constexpr uint32_t CfsrIaccviol      = 1UL << 0;
+    static constexpr uint32_t CfsrDaccviol      = 1UL << 1;
+    static constexpr uint32_t CfsrMunstkerr     = 1UL << 3;
+    static constexpr uint32_t CfsrMstkerr       = 1UL << 4;
+    static constexpr uint32_t CfsrMlsperr       = 1UL << 5;
+    static constexpr uint32_t CfsrMmarvalid     = 1UL << 7;
+    static constexpr uint32_t CfsrIbuserr       = 1UL << 8;
+    static constexpr uint32_t CfsrPreciserr     = 1UL << 9;
+    static constexpr uint32_t CfsrImpreciserr   = 1UL << 10;
+    static constexpr uint32_t CfsrUnstkerr      = 1UL << 11;
+    static constexpr uint32_t CfsrStkerr        = 1UL << 12;
+    static constexpr uint32_t CfsrLsperr        = 1UL << 13;
+    static constexpr uint32_t CfsrBfarvalid     = 1UL << 15;
+    static constexpr uint32_t CfsrUndefinstr    = 1UL << 16;
+    static constexpr uint32_t CfsrInvstate      = 1UL << 17;
+    static constexpr uint32_t CfsrInvpc         = 1UL << 18;
+    static constexpr uint32_t CfsrNocp          = 1UL << 19;
+    static constexpr uint32_t CfsrUnaligned     = 1UL << 24;
+    static constexpr uint32_t CfsrDivbyzero     = 1UL << 25;
+    static constexpr uint32_t HfsrVecttbl       = 1UL << 1;
+
+    static constexpr uint32_t StatsMagic        = 0xFA017A75U;
+
+    FaultManager(void) = delete;
+
+    /**
+     * @brief Decodes the fault status registers. The most severe cause wins if several bits are set.
+     */
+    static constexpr Info_t classify(uint32_t cfsr, uint32_t hfsr, uint32_t mmfar, uint32_t bfar) {
+        if((cfsr & (CfsrMstkerr | CfsrMunstkerr | CfsrStkerr | CfsrUnstkerr)) != 0U) {
+            return (Info_t{Class_t::StackError, false, 0U});
+        }
+        if((cfsr & (CfsrIaccviol | CfsrDaccviol | CfsrMlsperr)) != 0U) {
+            const bool valid = (cfsr & CfsrMmarvalid) != 0U;
+            return (Info_t{Class_t::MemoryAccess, valid, valid ? mmfar : 0U});
+        }
+        if((cfsr & (CfsrPreciserr | CfsrIbuserr | CfsrLsperr)) != 0U) {
+            const bool valid = (cfsr & CfsrBfarvalid) != 0U;
+            return (Info_t{Class_t::BusError, valid, valid ? bfar : 0U});
+        }
+        if((cfsr & CfsrImpreciserr) != 0U) {
+            return (Info_t{Class_t::ImpreciseBusError, false, 0U});
+        }
+        if((cfsr & (CfsrUndefinstr | CfsrInvstate | CfsrInvpc | CfsrNocp)) != 0U) {
+            return (Info_t{Class_t::InvalidInstruction, false, 0U});
+        }
+        if((cfsr & CfsrDivbyzero) != 0U) {
+            return (Info_t{Class_t::DivideByZero, false, 0U});
+        }
+        if((cfsr & CfsrUnaligned) != 0U) {
+            return (Info_t{Class_t::Unaligned, false, 0U});
+        }
+        if((hfsr & HfsrVecttbl) != 0U) {
+            return (Info_t{Class_t::VectorFetch, false, 0U});
+        }
+        return (Info_t{(cfsr == 0U) && (hfsr == 0U) ? Class_t::None : Class_t::Unknown, false, 0U});
+    }
+
+    /**
+     * @brief Recovery policy. Only faults of the code running inside run() whose effect is confined to the
+     * faulting instruction are recovered, everything else needs a reset.
+     *
+     * @param threadMode    the fault interrupted thread mode (EXC_RETURN bit 3)
+     * @param guarded       the fault happened inside run()
+     * @param numOfRestarts restarts of the module so far
+     * @param maxRestarts   restart budget of the module
+     */
+    static constexpr Action_t decide(Class_t cls, bool threadMode, bool guarded, uint32_t numOfRestarts,
+                                     uint32_t maxRestarts) {
+        const bool recoverable = (cls == Class_t::MemoryAccess) || (cls == Class_t::BusError) ||
+                                 (cls == Class_t::InvalidInstruction) || (cls == Class_t::DivideByZero) ||
+                                 (cls == Class_t::Unaligned);
+        return ((recoverable && threadMode && guarded && (numOfRestarts < maxRestarts)) ?
+                Action_t::Recover : Action_t::WarmReset);
+    }
+
+    /**
+     * @brief Enables the MemManage, BusFault and UsageFault exceptions and takes the warm boot token.
+     * 
+     * @return true if the system was started by a warm reset of the fault manager
+     */
+    static bool init(void);
+
+    /**
+     * @brief Clears the reset cause flags of RCC_CSR (RMVF). They accumulate over resets until cleared, so this has
+     * to be called once per boot after every reader of the flags: SystemInit_IsWarmBoot() (SFTRSTF) and
+     * Watchdog::takeMiss() (IWDGRSTF, WWDGRSTF).
+     */
+    static void clearResetFlags(void);
+
+    /**
+     * @brief Returns true if the current run was started by a warm reset of the fault manager.
+     */
+    static bool isWarmBoot(void) {
+        return (_warmBoot);
+    }
+
+    /**
+     * @brief Calls step() as part of module. If step() faults and the fault is recoverable, the module is
+     * restarted and run() returns false. Not reentrant, run() calls must not be nested.
+     * 
+     * @return true if step() returned normally
+     */
+    static bool run(Module_t& module, void (*step)(void));
+
+    static const Stats_t& getStats(void);
+
+    /**
+     * @brief Handles a fault, called by the fault handlers on the fault stack.
+     * 
+     * Returns only if the fault is recovered, the exception frame then resumes run(). Otherwise the fault is
+     * captured by CrashDump and the MCU is reset.
+     */
+    static void handle(uint32_t* frame, uint32_t excReturn);
+
+    /**
+     * @brief Captures the fault and performs a warm reset, i.e. a system reset that skips the slow init paths.
+     */
+    [[noreturn]] static void warmReset(const uint32_t* frame, uint32_t excReturn);
+
+private:
+    static inline bool _warmBoot{false};
+};
+
+}   // namespace diag
+
+/**
+ * @brief Common fault handler entry, called by the naked fault handlers on the fault stack. Returns only if the
+ * fault has been recovered.
+ */
+extern "C" void Fault_Handler(uint32_t* frame, uint32_t excReturn);
+
+/**
+ * @brief Overrides the weak hook of SystemInit(), true on a warm reset requested by the fault manager.
+ */
+extern "C" uint32_t SystemInit_IsWarmBoot(void);
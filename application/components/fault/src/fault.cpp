@@ -0,0 +1,179 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "fault.h"		// Include own header first because it needs to compile in isolation
+
+#include <csetjmp>
+
+#include "stm32g4xx.h"
+#include "crashdump.h"
+#include "memmap.h"
+
+NOINIT diag::FaultManager::Stats_t g_faultStats;    // survives warm resets
+NOINIT uint32_t g_warmBootToken;                    // set before a warm reset, read by SystemInit()
+
+namespace {
+
+constexpr uint32_t WarmBootMagic        = 0x3A5C9E01U;
+constexpr uint32_t TraceRecovered       = 0xFA000000U;      ///< CrashDump trace event, ORed with the fault class
+constexpr uint32_t ExcReturnThreadMode  = 1UL << 3;
+constexpr uint32_t XpsrThumb            = 1UL << 24;
+constexpr uint32_t XpsrStackAlign       = 1UL << 9;         ///< Frame has a padding word, must be kept
+constexpr uint32_t FramePc              = 6U;
+constexpr uint32_t FrameXpsr            = 7U;
+
+std::jmp_buf resumeContext;
+diag::FaultManager::Module_t* volatile activeModule = nullptr;
+
+/// Entered by the exception return of a recovered fault, in thread mode on the stack of the faulting code
+[[noreturn]] void resume(void) {
+    std::longjmp(resumeContext, 1);
+}
+
+}   // anonymous namespace
+
+namespace diag {
+
+// Bit definitions of classify() against the CMSIS core header
+static_assert(FaultManager::CfsrIaccviol == SCB_CFSR_IACCVIOL_Msk, "CFSR IACCVIOL");
+static_assert(FaultManager::CfsrDaccviol == SCB_CFSR_DACCVIOL_Msk, "CFSR DACCVIOL");
+static_assert(FaultManager::CfsrMunstkerr == SCB_CFSR_MUNSTKERR_Msk, "CFSR MUNSTKERR");
+static_assert(FaultManager::CfsrMstkerr == SCB_CFSR_MSTKERR_Msk, "CFSR MSTKERR");
+static_assert(FaultManager::CfsrMlsperr == SCB_CFSR_MLSPERR_Msk, "CFSR MLSPERR");
+static_assert(FaultManager::CfsrMmarvalid == SCB_CFSR_MMARVALID_Msk, "CFSR MMARVALID");
+static_assert(FaultManager::CfsrIbuserr == SCB_CFSR_IBUSERR_Msk, "CFSR IBUSERR");
+static_assert(FaultManager::CfsrPreciserr == SCB_CFSR_PRECISERR_Msk, "CFSR PRECISERR");
+static_assert(FaultManager::CfsrImpreciserr == SCB_CFSR_IMPRECISERR_Msk, "CFSR IMPRECISERR");
+static_assert(FaultManager::CfsrUnstkerr == SCB_CFSR_UNSTKERR_Msk, "CFSR UNSTKERR");
+static_assert(FaultManager::CfsrStkerr == SCB_CFSR_STKERR_Msk, "CFSR STKERR");
+static_assert(FaultManager::CfsrLsperr == SCB_CFSR_LSPERR_Msk, "CFSR LSPERR");
+static_assert(FaultManager::CfsrBfarvalid == SCB_CFSR_BFARVALID_Msk, "CFSR BFARVALID");
+static_assert(FaultManager::CfsrUndefinstr == SCB_CFSR_UNDEFINSTR_Msk, "CFSR UNDEFINSTR");
+static_assert(FaultManager::CfsrInvstate == SCB_CFSR_INVSTATE_Msk, "CFSR INVSTATE");
+static_assert(FaultManager::CfsrInvpc == SCB_CFSR_INVPC_Msk, "CFSR INVPC");
+static_assert(FaultManager::CfsrNocp == SCB_CFSR_NOCP_Msk, "CFSR NOCP");
+static_assert(FaultManager::CfsrUnaligned == SCB_CFSR_UNALIGNED_Msk, "CFSR UNALIGNED");
+static_assert(FaultManager::CfsrDivbyzero == SCB_CFSR_DIVBYZERO_Msk, "CFSR DIVBYZERO");
+static_assert(FaultManager::HfsrVecttbl == SCB_HFSR_VECTTBL_Msk, "HFSR VECTTBL");
+
+// Policy
+static_assert(FaultManager::classify(SCB_CFSR_DACCVIOL_Msk | SCB_CFSR_MMARVALID_Msk, 0U, 0x10U, 0U).address == 0x10U,
+              "MMFAR is taken if valid");
+static_assert(FaultManager::classify(SCB_CFSR_MSTKERR_Msk | SCB_CFSR_DACCVIOL_Msk, 0U, 0U, 0U).cls ==
+              FaultManager::Class_t::StackError, "stack errors win");
+static_assert(FaultManager::decide(FaultManager::Class_t::BusError, true, true, 0U, 1U) ==
+              FaultManager::Action_t::Recover, "precise bus error in a module is recovered");
+static_assert(FaultManager::decide(FaultManager::Class_t::BusError, false, true, 0U, 1U) ==
+              FaultManager::Action_t::WarmReset, "faults in handler mode reset");
+static_assert(FaultManager::decide(FaultManager::Class_t::ImpreciseBusError, true, true, 0U, 1U) ==
+              FaultManager::Action_t::WarmReset, "imprecise bus errors reset");
+static_assert(FaultManager::decide(FaultManager::Class_t::MemoryAccess, true, true, 1U, 1U) ==
+              FaultManager::Action_t::WarmReset, "restart budget exhausted");
+
+bool FaultManager::init(void) {
+    _warmBoot = (SystemInit_IsWarmBoot() != 0U);
+    g_warmBootToken = 0U;
+
+    if(g_faultStats.magic != StatsMagic) {
+        g_faultStats = Stats_t{StatsMagic, 0U, 0U, Class_t::None, 0U, 0U, nullptr};
+    }
+
+    // without the dedicated handlers every fault escalates to HardFault
+    SCB->SHCSR |= (SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk);
+    __DSB();
+    __ISB();
+    return (_warmBoot);
+}
+
+void FaultManager::clearResetFlags(void) {
+    RCC->CSR |= RCC_CSR_RMVF;
+}
+
+bool FaultManager::run(Module_t& module, void (*step)(void)) {
+    if(setjmp(resumeContext) != 0) {
+        // step() faulted, handle() returned into resume()
+        activeModule = nullptr;
+        if(module.restart != nullptr) {
+            module.restart();
+        }
+        return (false);
+    }
+
+    activeModule = &module;
+    step();
+    activeModule = nullptr;
+    return (true);
+}
+
+const FaultManager::Stats_t& FaultManager::getStats(void) {
+    return (g_faultStats);
+}
+
+COLD_FUNC void FaultManager::handle(uint32_t* frame, uint32_t excReturn) {
+    const uint32_t cfsr = SCB->CFSR;
+    const uint32_t hfsr = SCB->HFSR;
+    const Info_t info = classify(cfsr, hfsr, SCB->MMFAR, SCB->BFAR);
+    Module_t* module = activeModule;
+    const bool threadMode = (excReturn & ExcReturnThreadMode) != 0U;
+    const Action_t action = (module != nullptr) ?
+        decide(info.cls, threadMode, true, module->numOfRestarts, module->maxRestarts) : Action_t::WarmReset;
+
+    g_faultStats.lastClass   = info.cls;
+    g_faultStats.lastPc      = (info.cls != Class_t::StackError) ? frame[FramePc] : 0U;
+    g_faultStats.lastAddress = info.address;
+    g_faultStats.lastModule  = (module != nullptr) ? module->name : nullptr;
+
+    if(action == Action_t::WarmReset) {
+        warmReset(frame, excReturn);
+    }
+
+    // the status bits are sticky (write one to clear), a later fault must not see them
+    SCB->CFSR = cfsr;
+    SCB->HFSR = hfsr;
+    module->numOfRestarts++;
+    g_faultStats.numOfRecoveries++;
+    CrashDump::trace(TraceRecovered | static_cast<uint32_t>(info.cls));
+
+    // return from the exception into resume() instead of the faulting instruction
+    frame[FramePc]   = reinterpret_cast<uintptr_t>(&resume) & ~1U;
+    frame[FrameXpsr] = (frame[FrameXpsr] & XpsrStackAlign) | XpsrThumb;
+    __DSB();
+}
+
+COLD_FUNC void FaultManager::warmReset(const uint32_t* frame, uint32_t excReturn) {
+    g_faultStats.numOfWarmResets++;
+    g_warmBootToken = WarmBootMagic;
+    CrashDump_FaultHandler(frame, excReturn);       // captures the crash record and resets
+    for(;;) {}
+}
+
+}   // namespace diag
+
+// Called from the inline assembly of the fault handlers only, which LTO does not see
+extern "C" COLD_FUNC __attribute__((used)) void Fault_Handler(uint32_t* frame, uint32_t excReturn) {
+    diag::FaultManager::handle(frame, excReturn);
+}
+
+extern "C" uint32_t SystemInit_IsWarmBoot(void) {
+    // the token alone could be a random power-on content of .noinit
+    return (((g_warmBootToken == WarmBootMagic) && ((RCC->CSR & RCC_CSR_SFTRSTF) != 0U)) ? 1U : 0U);
+}
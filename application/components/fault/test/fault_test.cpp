@@ -0,0 +1,264 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "fault.h"
+#include "stm32g4xx.h"
+#include "unittest.h"
+
+#include <csetjmp>
+#include <cstring>
+
+using diag::FaultManager;
+using Class_t = FaultManager::Class_t;
+using Action_t = FaultManager::Action_t;
+
+extern diag::FaultManager::Stats_t g_faultStats;
+extern uint32_t g_warmBootToken;
+
+namespace {
+
+constexpr uint32_t ExcReturnThread  = 0xFFFFFFFDU;     ///< Thread mode, main stack
+constexpr uint32_t ExcReturnHandler = 0xFFFFFFF1U;     ///< Handler mode
+constexpr uint32_t XpsrThumb        = 1UL << 24;
+constexpr uint32_t XpsrStackAlign   = 1UL << 9;
+
+std::jmp_buf resetContext;
+uint32_t numOfCaptures = 0U;
+
+/// Exception frame of the faulting code: R0-R3, R12, LR, PC, xPSR
+uint32_t frame[8];
+uint32_t excReturn = ExcReturnThread;
+
+void setUp(void) {
+    TestRegisters_Reset();
+    std::memset(frame, 0, sizeof(frame));
+    frame[6] = 0x08001234U;
+    frame[7] = XpsrThumb | XpsrStackAlign | 0x3U;      // IPSR bits of the faulting context are dropped on resume
+    excReturn = ExcReturnThread;
+    g_faultStats.magic = 0U;
+    g_warmBootToken = 0U;
+    FaultManager::init();
+}
+
+void raiseFault(uint32_t cfsr, uint32_t address) {
+    TestScb.CFSR = cfsr;
+    TestScb.MMFAR = address;
+    TestScb.BFAR = address;
+    Fault_Handler(frame, excReturn);
+}
+
+void faultingStep(void) {
+    raiseFault(FaultManager::CfsrDaccviol | FaultManager::CfsrMmarvalid, 0x20U);
+}
+
+void restart(void) {}
+
+/// Runs a fault, returns true if it ended in the warm reset (CrashDump capture) instead of returning
+template<typename F>
+bool resets(F fault) {
+    if(setjmp(resetContext) != 0) {
+        return (true);
+    }
+    fault();
+    return (false);
+}
+
+void testClassify(void) {
+    struct Case_t {
+        uint32_t cfsr;
+        uint32_t hfsr;
+        Class_t cls;
+    };
+    constexpr Case_t cases[] = {
+        {0U, 0U, Class_t::None},
+        {0U, SCB_HFSR_FORCED_Msk, Class_t::Unknown},
+        {0U, SCB_HFSR_VECTTBL_Msk, Class_t::VectorFetch},
+        {SCB_CFSR_MSTKERR_Msk, 0U, Class_t::StackError},
+        {SCB_CFSR_MUNSTKERR_Msk, 0U, Class_t::StackError},
+        {SCB_CFSR_STKERR_Msk, 0U, Class_t::StackError},
+        {SCB_CFSR_UNSTKERR_Msk, 0U, Class_t::StackError},
+        {SCB_CFSR_IACCVIOL_Msk, 0U, Class_t::MemoryAccess},
+        {SCB_CFSR_DACCVIOL_Msk, 0U, Class_t::MemoryAccess},
+        {SCB_CFSR_MLSPERR_Msk, 0U, Class_t::MemoryAccess},
+        {SCB_CFSR_PRECISERR_Msk, 0U, Class_t::BusError},
+        {SCB_CFSR_IBUSERR_Msk, 0U, Class_t::BusError},
+        {SCB_CFSR_LSPERR_Msk, 0U, Class_t::BusError},
+        {SCB_CFSR_IMPRECISERR_Msk, 0U, Class_t::ImpreciseBusError},
+        {SCB_CFSR_UNDEFINSTR_Msk, 0U, Class_t::InvalidInstruction},
+        {SCB_CFSR_INVSTATE_Msk, 0U, Class_t::InvalidInstruction},
+        {SCB_CFSR_INVPC_Msk, 0U, Class_t::InvalidInstruction},
+        {SCB_CFSR_NOCP_Msk, 0U, Class_t::InvalidInstruction},
+        {SCB_CFSR_DIVBYZERO_Msk, 0U, Class_t::DivideByZero},
+        {SCB_CFSR_UNALIGNED_Msk, 0U, Class_t::Unaligned},
+        // the most severe cause wins
+        {SCB_CFSR_STKERR_Msk | SCB_CFSR_PRECISERR_Msk, 0U, Class_t::StackError},
+        {SCB_CFSR_DACCVIOL_Msk | SCB_CFSR_IMPRECISERR_Msk, 0U, Class_t::MemoryAccess},
+        {SCB_CFSR_IMPRECISERR_Msk | SCB_CFSR_UNDEFINSTR_Msk, 0U, Class_t::ImpreciseBusError},
+        {SCB_CFSR_DIVBYZERO_Msk | SCB_CFSR_UNALIGNED_Msk, SCB_HFSR_FORCED_Msk, Class_t::DivideByZero},
+    };
+
+    for(const Case_t& test : cases) {
+        TEST_EQUAL(test.cls, FaultManager::classify(test.cfsr, test.hfsr, 0x100U, 0x200U).cls);
+    }
+}
+
+void testFaultAddress(void) {
+    const FaultManager::Info_t mem = FaultManager::classify(SCB_CFSR_DACCVIOL_Msk | SCB_CFSR_MMARVALID_Msk, 0U, 0x100U, 0x200U);
+    TEST_CHECK(mem.addressValid);
+    TEST_EQUAL(0x100U, mem.address);
+
+    const FaultManager::Info_t bus = FaultManager::classify(SCB_CFSR_PRECISERR_Msk | SCB_CFSR_BFARVALID_Msk, 0U, 0x100U, 0x200U);
+    TEST_CHECK(bus.addressValid);
+    TEST_EQUAL(0x200U, bus.address);
+
+    // the address registers are only meaningful with their valid bit, and each belongs to its own fault
+    TEST_CHECK(!FaultManager::classify(SCB_CFSR_DACCVIOL_Msk, 0U, 0x100U, 0x200U).addressValid);
+    TEST_CHECK(!FaultManager::classify(SCB_CFSR_PRECISERR_Msk | SCB_CFSR_MMARVALID_Msk, 0U, 0x100U, 0x200U).addressValid);
+    TEST_EQUAL(0U, FaultManager::classify(SCB_CFSR_IMPRECISERR_Msk | SCB_CFSR_BFARVALID_Msk, 0U, 0x100U, 0x200U).address);
+}
+
+void testDecide(void) {
+    constexpr Class_t recoverable[] = {Class_t::MemoryAccess, Class_t::BusError, Class_t::InvalidInstruction,
+                                       Class_t::DivideByZero, Class_t::Unaligned};
+    constexpr Class_t fatal[] = {Class_t::None, Class_t::StackError, Class_t::ImpreciseBusError,
+                                 Class_t::VectorFetch, Class_t::Unknown};
+
+    for(Class_t cls : recoverable) {
+        TEST_EQUAL(Action_t::Recover, FaultManager::decide(cls, true, true, 0U, 3U));
+        TEST_EQUAL(Action_t::Recover, FaultManager::decide(cls, true, true, 2U, 3U));
+        TEST_EQUAL(Action_t::WarmReset, FaultManager::decide(cls, true, true, 3U, 3U));     // budget exhausted
+        TEST_EQUAL(Action_t::WarmReset, FaultManager::decide(cls, false, true, 0U, 3U));    // handler mode
+        TEST_EQUAL(Action_t::WarmReset, FaultManager::decide(cls, true, false, 0U, 3U));    // outside run()
+        TEST_EQUAL(Action_t::WarmReset, FaultManager::decide(cls, true, true, 0U, 0U));     // no budget
+    }
+    for(Class_t cls : fatal) {
+        TEST_EQUAL(Action_t::WarmReset, FaultManager::decide(cls, true, true, 0U, 3U));
+    }
+}
+
+void testInit(void) {
+    setUp();
+
+    TEST_EQUAL(SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk, TestScb.SHCSR);
+    TEST_EQUAL(FaultManager::StatsMagic, FaultManager::getStats().magic);
+    TEST_EQUAL(0U, FaultManager::getStats().numOfWarmResets);
+    TEST_CHECK(!FaultManager::isWarmBoot());
+
+    FaultManager::clearResetFlags();
+    TEST_EQUAL(RCC_CSR_RMVF, TestRcc.CSR);
+}
+
+void testFaultOutsideRunResets(void) {
+    setUp();
+    const uint32_t captures = numOfCaptures;
+
+    TEST_CHECK(resets([](void) { raiseFault(FaultManager::CfsrDaccviol | FaultManager::CfsrMmarvalid, 0x20U); }));
+    TEST_EQUAL(captures + 1U, numOfCaptures);
+
+    const FaultManager::Stats_t& stats = FaultManager::getStats();
+    TEST_EQUAL(1U, stats.numOfWarmResets);
+    TEST_EQUAL(0U, stats.numOfRecoveries);
+    TEST_EQUAL(Class_t::MemoryAccess, stats.lastClass);
+    TEST_EQUAL(0x08001234U, stats.lastPc);
+    TEST_EQUAL(0x20U, stats.lastAddress);
+    TEST_CHECK(stats.lastModule == nullptr);
+}
+
+void testWarmBoot(void) {
+    setUp();
+    TEST_CHECK(resets([](void) { raiseFault(FaultManager::CfsrStkerr, 0U); }));
+    TEST_EQUAL(0U, FaultManager::getStats().lastPc);        // the frame is not valid after a stacking error
+
+    // the token is only trusted together with the software reset flag
+    TEST_EQUAL(0U, SystemInit_IsWarmBoot());
+    TestRcc.CSR = RCC_CSR_SFTRSTF;
+    TEST_EQUAL(1U, SystemInit_IsWarmBoot());
+
+    // the statistics survive, the token is taken once
+    TEST_CHECK(FaultManager::init());
+    TEST_CHECK(FaultManager::isWarmBoot());
+    TEST_EQUAL(1U, FaultManager::getStats().numOfWarmResets);
+    TEST_EQUAL(0U, SystemInit_IsWarmBoot());
+}
+
+void testRecoveryInsideRun(void) {
+    setUp();
+    FaultManager::Module_t module{"sensor", &restart, 2U, 0U};
+    const uint32_t captures = numOfCaptures;
+
+    // on the host the handler returns into step() instead of resume(), the frame shows where the CPU would continue
+    TEST_CHECK(!resets([&](void) { FaultManager::run(module, &faultingStep); }));
+    TEST_EQUAL(1U, module.numOfRestarts);
+    TEST_EQUAL(captures, numOfCaptures);
+
+    const FaultManager::Stats_t& stats = FaultManager::getStats();
+    TEST_EQUAL(1U, stats.numOfRecoveries);
+    TEST_EQUAL(0U, stats.numOfWarmResets);
+    TEST_CHECK(stats.lastModule == module.name);
+    TEST_EQUAL(0x20U, stats.lastAddress);
+    TEST_CHECK(frame[6] != 0x08001234U);                    // resume() instead of the faulting instruction
+    TEST_EQUAL(0U, frame[6] & 1U);
+    TEST_EQUAL(XpsrThumb | XpsrStackAlign, frame[7]);
+}
+
+void testRestartBudget(void) {
+    setUp();
+    FaultManager::Module_t module{"sensor", &restart, 1U, 0U};
+
+    TEST_CHECK(!resets([&](void) { FaultManager::run(module, &faultingStep); }));
+    TEST_CHECK(resets([&](void) { FaultManager::run(module, &faultingStep); }));
+    TEST_EQUAL(1U, module.numOfRestarts);
+    TEST_EQUAL(1U, FaultManager::getStats().numOfRecoveries);
+    TEST_EQUAL(1U, FaultManager::getStats().numOfWarmResets);
+    TEST_CHECK(FaultManager::getStats().lastModule == module.name);
+}
+
+void testHandlerModeResets(void) {
+    setUp();
+    FaultManager::Module_t module{"sensor", &restart, 3U, 0U};
+    excReturn = ExcReturnHandler;
+
+    TEST_CHECK(resets([&](void) { FaultManager::run(module, &faultingStep); }));
+    TEST_EQUAL(0U, module.numOfRestarts);
+}
+
+}   // namespace
+
+/// CrashDump captures the record and resets the MCU, here the reset returns to the test
+extern "C" void CrashDump_FaultHandler(const uint32_t*, uint32_t) {
+    numOfCaptures++;
+    std::longjmp(resetContext, 1);
+}
+
+int main(void) {
+    return (unittest::run({
+        {"classify", testClassify},
+        {"fault address", testFaultAddress},
+        {"decide", testDecide},
+        {"init", testInit},
+        {"fault outside run() resets", testFaultOutsideRunResets},
+        {"warm boot", testWarmBoot},
+        {"recovery inside run()", testRecoveryInsideRun},
+        {"restart budget", testRestartBudget},
+        {"handler mode resets", testHandlerModeResets},
+    }));
+}
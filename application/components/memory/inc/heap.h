@@ -0,0 +1,60 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "tlsf.h"
+
+namespace mem {
+
+/**
+ * @brief System heap: one TLSF allocator per RAM region.
+ * 
+ * The SRAM arena covers the RAM between the end of the static data and the stack guard, the CCMSRAM
+ * arena the CCMSRAM behind .ccmram_bss. CCMSRAM is not reachable by DMA, it has to be requested explicitly.
+ * All functions lock interrupts for the duration of the O(1) operation and can be used from ISRs.
+ */
+class Heap {
+public:
+    enum class Region_t : uint8_t {
+        Sram,
+        Ccmsram
+    };
+
+    Heap(void) = delete;
+
+    static void* allocate(std::size_t bytes, Region_t region = Region_t::Sram);
+    static void* allocateAligned(std::size_t alignment, std::size_t bytes, Region_t region = Region_t::Sram);
+    static void* reallocate(void* ptr, std::size_t bytes);
+    static void release(void* ptr);
+
+    static Tlsf::Stats_t getStats(Region_t region);
+
+private:
+    static Tlsf& getAllocator(Region_t region);
+    static Tlsf* findOwner(const void* ptr);
+};
+
+}   // namespace mem
@@ -0,0 +1,259 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace mem {
+
+/**
+ * @brief Fixed-size pool of N objects of type T with O(1) lock-free allocate and release.
+ * 
+ * Released slots form a LIFO free list. Its head holds the slot index plus a tag that changes with every update,
+ * so a compare-and-swap (LDREX/STREX on Cortex-M) can not succeed on a stale head (ABA). The links are kept in an
+ * array next to the slots (4 bytes per slot): a pop may still read the link of a slot that another context has
+ * just taken, and that must not race with the construction of its object. Slots that have never
+ * been used are handed out by a bump counter, so an all-zero pool is a valid empty pool: it needs no constructor
+ * at runtime and can be placed into any zeroed section, e.g. CCMRAM_BSS (memmap.h). Allocate and release can be
+ * called from threads and ISRs concurrently.
+ */
+template<typename T, std::size_t N>
+class Pool {
+public:
+    static constexpr std::size_t Capacity       = N;
+    static constexpr uint32_t NumOfBuckets      = (N < 8U) ? static_cast<uint32_t>(N) : 8U;
+
+    static_assert((N > 0U) && (N < 0xFFFFU), "pool size must be 1..65534");
+
+    /**
+     * @brief Owning handle of a pooled object, destroys the object and returns the slot when it goes out of scope.
+     */
+    class Handle_t {
+    public:
+        constexpr Handle_t(void) = default;
+
+        Handle_t(Pool& pool, T* object) : _pool{&pool}, _object{object} {}
+
+        Handle_t(Handle_t&& other) : _pool{other._pool}, _object{other._object} {
+            other._object = nullptr;
+        }
+
+        Handle_t& operator=(Handle_t&& other) {
+            if(this != &other) {
+                reset();
+                _pool = other._pool;
+                _object = other._object;
+                other._object = nullptr;
+            }
+            return (*this);
+        }
+
+        Handle_t(const Handle_t&) = delete;
+        Handle_t& operator=(const Handle_t&) = delete;
+
+        ~Handle_t(void) {
+            reset();
+        }
+
+        void reset(void) {
+            if(_object != nullptr) {
+                _pool->destroy(_object);
+                _object = nullptr;
+            }
+        }
+
+        /// Gives up ownership, the caller has to call Pool::destroy()
+        T* release(void) {
+            T* object = _object;
+            _object = nullptr;
+            return (object);
+        }
+
+        T* get(void) const {
+            return (_object);
+        }
+
+        T* operator->(void) const {
+            return (_object);
+        }
+
+        T& operator*(void) const {
+            return (*_object);
+        }
+
+        explicit operator bool(void) const {
+            return (_object != nullptr);
+        }
+
+    private:
+        Pool* _pool{nullptr};
+        T* _object{nullptr};
+    };
+
+    struct Stats_t {
+        uint32_t inUse;
+        uint32_t peak;
+        uint32_t numOfFailures;
+        uint32_t histogram[NumOfBuckets];   ///< Allocations per fill level, bucket i counts levels (i*N/B, (i+1)*N/B]
+    };
+
+    constexpr Pool(void) = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /**
+     * @brief Returns uninitialized storage for one T or nullptr if the pool is exhausted.
+     */
+    void* allocate(void) {
+        Slot_t* slot = pop();
+        if(slot == nullptr) {
+            slot = takeUnused();
+        }
+        if(slot == nullptr) {
+            __atomic_fetch_add(&_numOfFailures, 1U, __ATOMIC_RELAXED);
+            return (nullptr);
+        }
+        account();
+        return (slot->object);
+    }
+
+    /**
+     * @brief Returns storage obtained by allocate(). The object must have been destroyed.
+     */
+    void release(void* ptr) {
+        if(ptr != nullptr) {
+            __atomic_fetch_sub(&_inUse, 1U, __ATOMIC_RELAXED);     // before the push: the level never exceeds N
+            push(static_cast<Slot_t*>(ptr));
+        }
+    }
+
+    template<typename... Args>
+    T* construct(Args&&... args) {
+        void* ptr = allocate();
+        return ((ptr != nullptr) ? new(ptr) T(std::forward<Args>(args)...) : nullptr);
+    }
+
+    void destroy(T* object) {
+        if(object != nullptr) {
+            object->~T();
+            release(object);
+        }
+    }
+
+    /**
+     * @brief Constructs an object owned by the returned handle, the handle is empty if the pool is exhausted.
+     */
+    template<typename... Args>
+    Handle_t create(Args&&... args) {
+        return (Handle_t(*this, construct(std::forward<Args>(args)...)));
+    }
+
+    bool owns(const void* ptr) const {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(&_slots[0]);
+        return ((address >= begin) && (address < (begin + sizeof(_slots))) && (((address - begin) % sizeof(Slot_t)) == 0U));
+    }
+
+    Stats_t getStats(void) const {
+        Stats_t stats{};
+        stats.inUse = __atomic_load_n(&_inUse, __ATOMIC_RELAXED);
+        stats.peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+        stats.numOfFailures = __atomic_load_n(&_numOfFailures, __ATOMIC_RELAXED);
+        for(uint32_t i = 0U; i < NumOfBuckets; i++) {
+            stats.histogram[i] = __atomic_load_n(&_histogram[i], __ATOMIC_RELAXED);
+        }
+        return (stats);
+    }
+
+private:
+    struct Slot_t {
+        alignas(T) unsigned char object[sizeof(T)];
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "the free list must be usable from ISRs");
+
+    static constexpr uint32_t IndexMask = 0xFFFFU;
+    static constexpr uint32_t TagStep   = 0x10000U;
+
+    Slot_t* pop(void) {
+        uint32_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+        for(;;) {
+            const uint32_t index = head & IndexMask;
+            if(index == 0U) {
+                return (nullptr);
+            }
+            // a concurrent pop may have handed out the slot, the link is stale then and the tag makes the CAS fail
+            const uint32_t next = _next[index - 1U].load(std::memory_order_relaxed);
+            const uint32_t desired = ((head + TagStep) & ~IndexMask) | next;
+            if(__atomic_compare_exchange_n(&_head, &head, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return (&_slots[index - 1U]);
+            }
+        }
+    }
+
+    void push(Slot_t* slot) {
+        const uint32_t index = static_cast<uint32_t>(slot - &_slots[0]) + 1U;
+        uint32_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+        for(;;) {
+            _next[index - 1U].store(head & IndexMask, std::memory_order_relaxed);
+            const uint32_t desired = ((head + TagStep) & ~IndexMask) | index;
+            if(__atomic_compare_exchange_n(&_head, &head, desired, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+                return;
+            }
+        }
+    }
+
+    Slot_t* takeUnused(void) {
+        uint32_t used = __atomic_load_n(&_numOfUsedSlots, __ATOMIC_RELAXED);
+        while(used < N) {
+            if(__atomic_compare_exchange_n(&_numOfUsedSlots, &used, used + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return (&_slots[used]);
+            }
+        }
+        return (nullptr);
+    }
+
+    void account(void) {
+        const uint32_t level = __atomic_add_fetch(&_inUse, 1U, __ATOMIC_RELAXED);
+        uint32_t peak = __atomic_load_n(&_peak, __ATOMIC_RELAXED);
+        while((level > peak) && !__atomic_compare_exchange_n(&_peak, &peak, level, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+
+        const uint32_t bucket = static_cast<uint32_t>(((level - 1U) * NumOfBuckets) / N);
+        __atomic_fetch_add(&_histogram[bucket], 1U, __ATOMIC_RELAXED);
+    }
+
+    Slot_t _slots[N]{};
+    std::atomic<uint32_t> _next[N]{};       ///< Index + 1 of the next free slot, valid while the slot is free
+    uint32_t _head{0U};                     ///< Tag (upper 16 bits) and index + 1 (lower 16 bits) of the free list
+    uint32_t _numOfUsedSlots{0U};           ///< Slots handed out at least once
+    uint32_t _inUse{0U};
+    uint32_t _peak{0U};
+    uint32_t _numOfFailures{0U};
+    uint32_t _histogram[NumOfBuckets]{};
+};
+
+}   // namespace mem
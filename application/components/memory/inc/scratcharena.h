@@ -0,0 +1,201 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace mem {
+
+/**
+ * @brief Bump allocator for temporaries that all die at the same time, e.g. at the end of a control cycle.
+ * 
+ * allocate() aligns and advances an offset (a few instructions, no per-allocation header), memory is only given
+ * back as a whole: reset() at the end of the cycle, or a Scope_t that rewinds to the position at its construction.
+ * An allocation that does not fit returns nullptr and is counted as overflow, the arena stays usable. The peak is
+ * sampled when the arena is rewound, which keeps it out of the allocation path. Not thread safe, use one arena per
+ * execution context.
+ */
+class ScratchArena {
+public:
+    using Marker_t = uintptr_t;
+
+    /**
+     * @brief Rewinds the arena to the position at construction when it goes out of scope.
+     */
+    class Scope_t {
+    public:
+        explicit Scope_t(ScratchArena& arena) : _arena{arena}, _marker{arena.getMarker()} {}
+
+        ~Scope_t(void) {
+            _arena.reset(_marker);
+        }
+
+        Scope_t(const Scope_t&) = delete;
+        Scope_t& operator=(const Scope_t&) = delete;
+
+    private:
+        ScratchArena& _arena;
+        Marker_t _marker;
+    };
+
+    ScratchArena(void* memory, std::size_t bytes) :
+        _begin{reinterpret_cast<uintptr_t>(memory)},
+        _current{_begin},
+        _end{_begin + bytes},
+        _peak{_begin} {}
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Returns bytes of storage aligned to alignment (a power of two) or nullptr if the arena is exhausted.
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        const uintptr_t aligned = (_current + alignment - 1U) & ~static_cast<uintptr_t>(alignment - 1U);
+        if((aligned > _end) || (bytes > (_end - aligned))) {
+            _numOfOverflows++;
+            return (nullptr);
+        }
+        _current = aligned + bytes;
+        return (reinterpret_cast<void*>(aligned));
+    }
+
+    /**
+     * @brief Returns uninitialized storage for count objects of type T or nullptr if the arena is exhausted.
+     */
+    template<typename T>
+    T* allocate(std::size_t count) {
+        if(count > (static_cast<std::size_t>(-1) / sizeof(T))) {
+            _numOfOverflows++;
+            return (nullptr);
+        }
+        return (static_cast<T*>(allocate(count * sizeof(T), alignof(T))));
+    }
+
+    Marker_t getMarker(void) const {
+        return (_current);
+    }
+
+    /**
+     * @brief Releases everything allocated after the marker was taken.
+     */
+    void reset(Marker_t marker) {
+        updatePeak();
+        _current = marker;
+    }
+
+    /**
+     * @brief Releases all allocations, called at the end of the cycle.
+     */
+    void reset(void) {
+        reset(_begin);
+    }
+
+    std::size_t getCapacity(void) const {
+        return (_end - _begin);
+    }
+
+    std::size_t getUsed(void) const {
+        return (_current - _begin);
+    }
+
+    std::size_t getPeak(void) {
+        updatePeak();
+        return (_peak - _begin);
+    }
+
+    uint32_t getNumOfOverflows(void) const {
+        return (_numOfOverflows);
+    }
+
+private:
+    void updatePeak(void) {
+        if(_current > _peak) {
+            _peak = _current;
+        }
+    }
+
+    uintptr_t _begin;
+    uintptr_t _current;
+    uintptr_t _end;
+    uintptr_t _peak;
+    uint32_t _numOfOverflows{0U};
+};
+
+/**
+ * @brief Arena with its own storage, e.g. as a static member of the control loop.
+ */
+template<std::size_t Size>
+class StaticScratchArena : public ScratchArena {
+public:
+    StaticScratchArena(void) : ScratchArena(_storage, Size) {}
+
+private:
+    alignas(std::max_align_t) unsigned char _storage[Size];
+};
+
+/**
+ * @brief STL allocator on top of a ScratchArena. deallocate() is a no-op, the memory returns with the arena reset,
+ * so containers must not outlive the cycle (scope) they were filled in. Built without exceptions, an overflow aborts.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(ScratchArena& arena) : _arena{&arena} {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena{other.getArena()} {}
+
+    T* allocate(std::size_t count) {
+        T* ptr = _arena->allocate<T>(count);
+        if(ptr == nullptr) {
+            std::abort();
+        }
+        return (ptr);
+    }
+
+    void deallocate(T*, std::size_t) {}
+
+    ScratchArena* getArena(void) const {
+        return (_arena);
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return (_arena == other.getArena());
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return (_arena != other.getArena());
+    }
+
+private:
+    ScratchArena* _arena;
+};
+
+}   // namespace mem
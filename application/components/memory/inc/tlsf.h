@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mem {
+
+/**
+ * @brief Two-level segregated fit allocator with O(1) allocate and free.
+ * 
+ * Free blocks are kept in lists indexed by a first level (power of two) and a second level (linear subdivision)
+ * size class. Two bitmaps locate the smallest non-empty class with a find-first-set, so neither allocate nor free
+ * walks a list. Neighbouring free blocks are merged immediately, every block carries an 8 byte (two pointer) header.
+ * The allocator is not thread safe, callers have to lock.
+ */
+class Tlsf {
+public:
+    static constexpr std::size_t Alignment  = 8U;
+    static constexpr uint32_t SlLog2        = 4U;                           ///< 16 second level classes
+    static constexpr uint32_t FlMaxLog2     = 18U;                          ///< Largest block < 256 KiB
+    static constexpr uint32_t FlShift       = SlLog2 + 3U;                  ///< log2(Alignment)
+    static constexpr uint32_t SlCount       = 1U << SlLog2;
+    static constexpr uint32_t FlCount       = FlMaxLog2 - FlShift + 1U;
+    static constexpr std::size_t SmallBlock = std::size_t{1} << FlShift;    ///< Below: linear classes of Alignment
+
+    struct Stats_t {
+        std::size_t totalBytes;         ///< Arena bytes available for blocks (incl. headers)
+        std::size_t usedBytes;          ///< Allocated blocks incl. headers
+        std::size_t peakBytes;          ///< Maximum of usedBytes
+        std::size_t largestFree;        ///< Largest request allocate() serves right now
+        uint32_t numOfAllocations;      ///< Live allocations
+        uint32_t numOfFailures;         ///< Allocations that could not be served
+        uint32_t fragmentation;         ///< 100 - largestFree / free bytes in percent
+    };
+
+    constexpr Tlsf(void) = default;
+    Tlsf(const Tlsf&) = delete;
+    Tlsf& operator=(const Tlsf&) = delete;
+
+    /**
+     * @brief Adds a memory area to the allocator. Several arenas can be added, blocks never span arenas.
+     * 
+     * @return false if the area is too small or too large
+     */
+    bool addArena(void* memory, std::size_t bytes);
+
+    void* allocate(std::size_t bytes);
+
+    /**
+     * @brief Allocates a block whose payload is aligned to alignment (a power of two). The padding in front of
+     * the payload is returned to the free lists as a block of its own.
+     */
+    void* allocateAligned(std::size_t alignment, std::size_t bytes);
+
+    /**
+     * @brief Resizes an allocated block. Shrinking and growing into a free successor happen in place, a shrunk
+     * tail goes back to the free lists. Otherwise the payload is moved to a new block.
+     */
+    void* reallocate(void* ptr, std::size_t bytes);
+    void release(void* ptr);
+
+    /**
+     * @brief Returns the usable size of an allocated block (at least the requested size).
+     */
+    static std::size_t getUsableSize(const void* ptr);
+
+    /**
+     * @brief Returns true if ptr has been allocated from one of the arenas of this allocator.
+     */
+    bool owns(const void* ptr) const;
+
+    /**
+     * @brief Returns the statistics in O(1). allocate() rounds a request up to the next size class, so the
+     * largest request it serves is the lower bound of the highest non-empty class, which can be below the size of
+     * the largest free block.
+     */
+    Stats_t getStats(void) const;
+
+private:
+    struct Block_t;
+
+    static void mappingInsert(std::size_t size, uint32_t& fl, uint32_t& sl);
+    static void mappingSearch(std::size_t size, uint32_t& fl, uint32_t& sl);
+    Block_t* findSuitable(uint32_t& fl, uint32_t& sl) const;
+    void insertFree(Block_t* block);
+    void removeFree(Block_t* block, uint32_t fl, uint32_t sl);
+    void removeFree(Block_t* block);
+    void split(Block_t* block, std::size_t size);
+    Block_t* take(std::size_t size);
+    void onAllocated(const Block_t* block);
+
+    static constexpr uint32_t MaxArenas = 4U;
+
+    struct Arena_t {
+        const uint8_t* begin;
+        const uint8_t* end;
+    };
+
+    uint32_t _flBitmap{0U};
+    uint32_t _slBitmap[FlCount]{};
+    Block_t* _blocks[FlCount][SlCount]{};
+    Arena_t _arenas[MaxArenas]{};
+    uint32_t _numOfArenas{0U};
+    std::size_t _totalBytes{0U};
+    std::size_t _usedBytes{0U};
+    std::size_t _peakBytes{0U};
+    uint32_t _numOfAllocations{0U};
+    uint32_t _numOfFailures{0U};
+};
+
+}   // namespace mem
@@ -0,0 +1,117 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "heap.h"		// Include own header first because it needs to compile in isolation
+
+#include "stm32g4xx.h"
+
+// Arena limits, defined by the linker script
+extern "C" uint8_t end;
+extern "C" uint8_t _sguard;
+extern "C" uint8_t _eccmbss;
+extern "C" uint8_t _eccmsram;
+
+namespace {
+
+// constant initialized, usable before the static constructors run
+mem::Tlsf g_sram;
+mem::Tlsf g_ccmsram;
+bool g_initialized{false};
+
+class CriticalSection {
+public:
+    CriticalSection(void) : _primask{__get_PRIMASK()} {
+        __disable_irq();
+    }
+
+    ~CriticalSection(void) {
+        __set_PRIMASK(_primask);
+    }
+
+private:
+    uint32_t _primask;
+};
+
+/// Called with interrupts locked
+void init(void) {
+    if(!g_initialized) {
+        g_initialized = true;
+        (void)g_sram.addArena(&end, static_cast<std::size_t>(&_sguard - &end));
+        (void)g_ccmsram.addArena(&_eccmbss, static_cast<std::size_t>(&_eccmsram - &_eccmbss));
+    }
+}
+
+}   // anonymous namespace
+
+namespace mem {
+
+Tlsf& Heap::getAllocator(Region_t region) {
+    return ((region == Region_t::Ccmsram) ? g_ccmsram : g_sram);
+}
+
+Tlsf* Heap::findOwner(const void* ptr) {
+    if(g_sram.owns(ptr)) {
+        return (&g_sram);
+    }
+    if(g_ccmsram.owns(ptr)) {
+        return (&g_ccmsram);
+    }
+    return (nullptr);
+}
+
+void* Heap::allocate(std::size_t bytes, Region_t region) {
+    CriticalSection lock;
+    init();
+    return (getAllocator(region).allocate(bytes));
+}
+
+void* Heap::allocateAligned(std::size_t alignment, std::size_t bytes, Region_t region) {
+    CriticalSection lock;
+    init();
+    return (getAllocator(region).allocateAligned(alignment, bytes));
+}
+
+void* Heap::reallocate(void* ptr, std::size_t bytes) {
+    CriticalSection lock;
+    init();
+    if(ptr == nullptr) {
+        return (g_sram.allocate(bytes));
+    }
+    Tlsf* owner = findOwner(ptr);
+    return ((owner != nullptr) ? owner->reallocate(ptr, bytes) : nullptr);
+}
+
+void Heap::release(void* ptr) {
+    CriticalSection lock;
+    Tlsf* owner = findOwner(ptr);
+    if(owner != nullptr) {
+        owner->release(ptr);
+    }
+}
+
+Tlsf::Stats_t Heap::getStats(Region_t region) {
+    CriticalSection lock;
+    init();
+    return (getAllocator(region).getStats());
+}
+
+}   // namespace mem
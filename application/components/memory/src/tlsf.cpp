@@ -0,0 +1,424 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tlsf.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstring>
+
+#include "memmap.h"
+
+namespace {
+
+constexpr std::size_t FreeBit       = 1U;
+constexpr std::size_t PrevFreeBit   = 2U;
+constexpr std::size_t FlagMask      = mem::Tlsf::Alignment - 1U;
+constexpr std::size_t HeaderSize    = 2U * sizeof(void*);
+constexpr std::size_t MinBlockSize  = 2U * sizeof(void*);
+constexpr std::size_t MaxBlockSize  = (std::size_t{1} << mem::Tlsf::FlMaxLog2) - mem::Tlsf::Alignment;
+
+static_assert((HeaderSize % mem::Tlsf::Alignment) == 0U, "headers must keep the payload aligned");
+static_assert(mem::Tlsf::SlCount <= 32U, "second level bitmap is 32 bit");
+static_assert(mem::Tlsf::FlCount <= 32U, "first level bitmap is 32 bit");
+
+constexpr std::size_t alignUp(std::size_t value) {
+    return ((value + mem::Tlsf::Alignment - 1U) & ~(mem::Tlsf::Alignment - 1U));
+}
+
+inline uint32_t fls(std::size_t value) {
+    return (31U - static_cast<uint32_t>(__builtin_clz(static_cast<uint32_t>(value))));
+}
+
+inline uint32_t ffs(uint32_t value) {
+    return (static_cast<uint32_t>(__builtin_ctz(value)));
+}
+
+}   // anonymous namespace
+
+namespace mem {
+
+/**
+ * Physical block header, followed by the payload. nextFree/prevFree overlay the payload and are only valid while
+ * the block is free. The size is a multiple of Alignment, the low bits hold the flags.
+ */
+struct Tlsf::Block_t {
+    Block_t* prevPhys;
+    std::size_t size;
+    Block_t* nextFree;
+    Block_t* prevFree;
+
+    std::size_t getSize(void) const {
+        return (size & ~FlagMask);
+    }
+
+    void setSize(std::size_t newSize) {
+        size = newSize | (size & FlagMask);
+    }
+
+    bool isFree(void) const {
+        return ((size & FreeBit) != 0U);
+    }
+
+    bool isPrevFree(void) const {
+        return ((size & PrevFreeBit) != 0U);
+    }
+
+    uint8_t* getPayload(void) {
+        return (reinterpret_cast<uint8_t*>(this) + HeaderSize);
+    }
+
+    Block_t* getNext(void) {
+        return (reinterpret_cast<Block_t*>(getPayload() + getSize()));
+    }
+
+    static Block_t* fromPayload(const void* ptr) {
+        return (reinterpret_cast<Block_t*>(const_cast<uint8_t*>(static_cast<const uint8_t*>(ptr)) - HeaderSize));
+    }
+
+    /// Marks the block free and links its physical successor back to it
+    void markFree(void) {
+        size |= FreeBit;
+        Block_t* next = getNext();
+        next->prevPhys = this;
+        next->size |= PrevFreeBit;
+    }
+
+    void markUsed(void) {
+        size &= ~FreeBit;
+        getNext()->size &= ~PrevFreeBit;
+    }
+};
+
+void Tlsf::mappingInsert(std::size_t size, uint32_t& fl, uint32_t& sl) {
+    if(size < SmallBlock) {
+        fl = 0U;
+        sl = static_cast<uint32_t>(size / (SmallBlock / SlCount));
+    } else {
+        const uint32_t msb = fls(size);
+        sl = static_cast<uint32_t>(size >> (msb - SlLog2)) ^ SlCount;
+        fl = msb - (FlShift - 1U);
+    }
+}
+
+void Tlsf::mappingSearch(std::size_t size, uint32_t& fl, uint32_t& sl) {
+    // round up to the next class so that any block of the found list fits
+    if(size >= SmallBlock) {
+        size += (std::size_t{1} << (fls(size) - SlLog2)) - 1U;
+    }
+    mappingInsert(size, fl, sl);
+}
+
+Tlsf::Block_t* Tlsf::findSuitable(uint32_t& fl, uint32_t& sl) const {
+    uint32_t slMap = _slBitmap[fl] & (~0U << sl);
+
+    if(slMap == 0U) {
+        const uint32_t flMap = (fl + 1U < 32U) ? (_flBitmap & (~0U << (fl + 1U))) : 0U;
+        if(flMap == 0U) {
+            return (nullptr);
+        }
+        fl = ffs(flMap);
+        slMap = _slBitmap[fl];
+    }
+    sl = ffs(slMap);
+    return (_blocks[fl][sl]);
+}
+
+void Tlsf::insertFree(Block_t* block) {
+    uint32_t fl;
+    uint32_t sl;
+    mappingInsert(block->getSize(), fl, sl);
+
+    Block_t* head = _blocks[fl][sl];
+    block->nextFree = head;
+    block->prevFree = nullptr;
+    if(head != nullptr) {
+        head->prevFree = block;
+    }
+    _blocks[fl][sl] = block;
+    _flBitmap |= (1U << fl);
+    _slBitmap[fl] |= (1U << sl);
+}
+
+void Tlsf::removeFree(Block_t* block, uint32_t fl, uint32_t sl) {
+    if(block->nextFree != nullptr) {
+        block->nextFree->prevFree = block->prevFree;
+    }
+    if(block->prevFree != nullptr) {
+        block->prevFree->nextFree = block->nextFree;
+    }
+    if(_blocks[fl][sl] == block) {
+        _blocks[fl][sl] = block->nextFree;
+        if(block->nextFree == nullptr) {
+            _slBitmap[fl] &= ~(1U << sl);
+            if(_slBitmap[fl] == 0U) {
+                _flBitmap &= ~(1U << fl);
+            }
+        }
+    }
+}
+
+void Tlsf::removeFree(Block_t* block) {
+    uint32_t fl;
+    uint32_t sl;
+    mappingInsert(block->getSize(), fl, sl);
+    removeFree(block, fl, sl);
+}
+
+void Tlsf::split(Block_t* block, std::size_t size) {
+    // hand the tail back to the free lists if it can hold a block of its own
+    if(block->getSize() >= (size + HeaderSize + MinBlockSize)) {
+        Block_t* rest = reinterpret_cast<Block_t*>(block->getPayload() + size);
+        rest->size = 0U;
+        rest->setSize(block->getSize() - size - HeaderSize);
+        block->setSize(size);
+        rest->prevPhys = block;
+        rest->markFree();
+        insertFree(rest);
+    }
+}
+
+void Tlsf::onAllocated(const Block_t* block) {
+    _usedBytes += block->getSize() + HeaderSize;
+    if(_usedBytes > _peakBytes) {
+        _peakBytes = _usedBytes;
+    }
+    _numOfAllocations++;
+}
+
+bool Tlsf::addArena(void* memory, std::size_t bytes) {
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(memory) + Alignment - 1U) & ~(Alignment - 1U);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(memory) + bytes) & ~(Alignment - 1U);
+
+    if((_numOfArenas >= MaxArenas) || (end <= begin) || ((end - begin) < (2U * HeaderSize + MinBlockSize))) {
+        return (false);
+    }
+
+    // one free block covering the arena, terminated by a used zero size sentinel
+    const std::size_t size = (end - begin) - 2U * HeaderSize;
+    if(size > MaxBlockSize) {
+        return (false);
+    }
+    Block_t* block = reinterpret_cast<Block_t*>(begin);
+    block->prevPhys = nullptr;
+    block->size = size;
+    Block_t* sentinel = block->getNext();
+    sentinel->size = 0U;
+    block->markFree();
+    insertFree(block);
+
+    _arenas[_numOfArenas].begin = reinterpret_cast<const uint8_t*>(begin);
+    _arenas[_numOfArenas].end = reinterpret_cast<const uint8_t*>(end);
+    _numOfArenas++;
+    _totalBytes += size + HeaderSize;
+    return (true);
+}
+
+Tlsf::Block_t* Tlsf::take(std::size_t size) {
+    uint32_t fl;
+    uint32_t sl;
+    mappingSearch(size, fl, sl);
+    Block_t* block = (fl < FlCount) ? findSuitable(fl, sl) : nullptr;
+    if(block == nullptr) {
+        _numOfFailures++;
+        return (nullptr);
+    }
+    removeFree(block, fl, sl);
+    return (block);
+}
+
+HOT_FUNC void* Tlsf::allocate(std::size_t bytes) {
+    const std::size_t size = (bytes < MinBlockSize) ? MinBlockSize : alignUp(bytes);
+    if((bytes > MaxBlockSize) || (size > MaxBlockSize)) {
+        _numOfFailures++;
+        return (nullptr);
+    }
+
+    Block_t* block = take(size);
+    if(block == nullptr) {
+        return (nullptr);
+    }
+
+    split(block, size);
+    block->markUsed();
+    onAllocated(block);
+    return (block->getPayload());
+}
+
+void* Tlsf::allocateAligned(std::size_t alignment, std::size_t bytes) {
+    if(alignment <= Alignment) {
+        return (allocate(bytes));
+    }
+
+    // room for the padding, which has to hold a free block if it is not empty
+    constexpr std::size_t MinPadding = HeaderSize + MinBlockSize;
+    const std::size_t size = (bytes < MinBlockSize) ? MinBlockSize : alignUp(bytes);
+    if(((alignment & (alignment - 1U)) != 0U) || (bytes > MaxBlockSize) || (alignment > MaxBlockSize) ||
+       ((size + alignment + MinPadding) > MaxBlockSize)) {
+        _numOfFailures++;
+        return (nullptr);
+    }
+
+    Block_t* block = take(size + alignment + MinPadding);
+    if(block == nullptr) {
+        return (nullptr);
+    }
+
+    const uintptr_t payload = reinterpret_cast<uintptr_t>(block->getPayload());
+    uintptr_t aligned = (payload + alignment - 1U) & ~(alignment - 1U);
+    if((aligned != payload) && ((aligned - payload) < MinPadding)) {
+        aligned = (payload + MinPadding + alignment - 1U) & ~(alignment - 1U);
+    }
+
+    if(aligned != payload) {
+        // the padding stays free, a free block never has a free predecessor
+        const std::size_t padding = aligned - payload;
+        Block_t* alignedBlock = Block_t::fromPayload(reinterpret_cast<void*>(aligned));
+        alignedBlock->size = 0U;
+        alignedBlock->setSize(block->getSize() - padding);
+        block->setSize(padding - HeaderSize);
+        block->markFree();
+        insertFree(block);
+        block = alignedBlock;
+    }
+
+    split(block, size);
+    block->markUsed();
+    onAllocated(block);
+    return (block->getPayload());
+}
+
+HOT_FUNC void Tlsf::release(void* ptr) {
+    if(ptr == nullptr) {
+        return;
+    }
+
+    Block_t* block = Block_t::fromPayload(ptr);
+    _usedBytes -= block->getSize() + HeaderSize;
+    _numOfAllocations--;
+
+    // merge with the physical neighbours, the sentinel is never free so the arena end is safe
+    if(block->isPrevFree()) {
+        Block_t* prev = block->prevPhys;
+        removeFree(prev);
+        prev->setSize(prev->getSize() + HeaderSize + block->getSize());
+        block = prev;
+    }
+    Block_t* next = block->getNext();
+    if(next->isFree()) {
+        removeFree(next);
+        block->setSize(block->getSize() + HeaderSize + next->getSize());
+    }
+    block->markFree();
+    insertFree(block);
+}
+
+void* Tlsf::reallocate(void* ptr, std::size_t bytes) {
+    if(ptr == nullptr) {
+        return (allocate(bytes));
+    }
+    if(bytes == 0U) {
+        release(ptr);
+        return (nullptr);
+    }
+
+    Block_t* block = Block_t::fromPayload(ptr);
+    const std::size_t size = (bytes < MinBlockSize) ? MinBlockSize : alignUp(bytes);
+    const std::size_t current = block->getSize();
+    if(bytes > MaxBlockSize) {
+        _numOfFailures++;
+        return (nullptr);
+    }
+
+    if(size <= current) {
+        // shrink in place, the tail is merged with a free successor and goes back to the free lists
+        Block_t* next = block->getNext();
+        if(next->isFree()) {
+            removeFree(next);
+            block->setSize(current + HeaderSize + next->getSize());
+        }
+        split(block, size);
+        _usedBytes -= current - block->getSize();
+        return (ptr);
+    }
+
+    // grow in place into a free successor
+    Block_t* next = block->getNext();
+    if(next->isFree() && ((current + HeaderSize + next->getSize()) >= size)) {
+        removeFree(next);
+        block->setSize(current + HeaderSize + next->getSize());
+        block->getNext()->size &= ~PrevFreeBit;
+        split(block, size);
+        _usedBytes += block->getSize() - current;
+        if(_usedBytes > _peakBytes) {
+            _peakBytes = _usedBytes;
+        }
+        return (ptr);
+    }
+
+    void* moved = allocate(bytes);
+    if(moved != nullptr) {
+        std::memcpy(moved, ptr, current);
+        release(ptr);
+    }
+    return (moved);
+}
+
+std::size_t Tlsf::getUsableSize(const void* ptr) {
+    return ((ptr != nullptr) ? Block_t::fromPayload(ptr)->getSize() : 0U);
+}
+
+bool Tlsf::owns(const void* ptr) const {
+    const uint8_t* address = static_cast<const uint8_t*>(ptr);
+    for(uint32_t i = 0U; i < _numOfArenas; i++) {
+        if((address >= _arenas[i].begin) && (address < _arenas[i].end)) {
+            return (true);
+        }
+    }
+    return (false);
+}
+
+Tlsf::Stats_t Tlsf::getStats(void) const {
+    Stats_t stats{};
+    stats.totalBytes = _totalBytes;
+    stats.usedBytes = _usedBytes;
+    stats.peakBytes = _peakBytes;
+    stats.numOfAllocations = _numOfAllocations;
+    stats.numOfFailures = _numOfFailures;
+
+    if(_flBitmap != 0U) {
+        // lower bound of the highest non-empty class, mappingSearch() keeps such a request in this class
+        const uint32_t fl = fls(_flBitmap);
+        const uint32_t sl = fls(_slBitmap[fl]);
+        if(fl == 0U) {
+            stats.largestFree = sl * (SmallBlock / SlCount);
+        } else {
+            stats.largestFree = static_cast<std::size_t>(SlCount + sl) << (fl + FlShift - 1U - SlLog2);
+        }
+    }
+
+    const std::size_t freeBytes = _totalBytes - _usedBytes;
+    if(freeBytes > HeaderSize) {
+        stats.fragmentation = 100U - static_cast<uint32_t>((stats.largestFree * 100U) / (freeBytes - HeaderSize));
+    }
+    return (stats);
+}
+
+}   // namespace mem
@@ -0,0 +1,182 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pool.h"
+#include "unittest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using mem::Pool;
+
+namespace {
+
+struct Message_t {
+    explicit Message_t(uint32_t id) : id{id} {
+        numOfLive++;
+    }
+
+    ~Message_t(void) {
+        numOfLive--;
+    }
+
+    uint32_t id;
+    uint32_t payload[3]{};
+
+    static inline int32_t numOfLive = 0;
+};
+
+/// Zero-initialized without a constructor call, like a pool in CCMRAM_BSS
+Pool<Message_t, 16U> staticPool;
+
+void testExhaustion(void) {
+    Pool<Message_t, 4U> pool;
+    Message_t* messages[4];
+
+    for(uint32_t i = 0U; i < 4U; i++) {
+        messages[i] = pool.construct(i);
+        TEST_CHECK(messages[i] != nullptr);
+        TEST_CHECK(pool.owns(messages[i]));
+    }
+    TEST_CHECK(pool.construct(4U) == nullptr);
+    TEST_EQUAL(4U, pool.getStats().inUse);
+    TEST_EQUAL(1U, pool.getStats().numOfFailures);
+
+    for(Message_t* message : messages) {
+        pool.destroy(message);
+    }
+    TEST_EQUAL(0, Message_t::numOfLive);
+    TEST_EQUAL(0U, pool.getStats().inUse);
+    TEST_EQUAL(4U, pool.getStats().peak);
+}
+
+void testLifoReuse(void) {
+    Pool<Message_t, 4U> pool;
+    Message_t* first = pool.construct(1U);
+    Message_t* second = pool.construct(2U);
+
+    pool.destroy(first);
+    pool.destroy(second);
+    Message_t* third = pool.construct(3U);
+    Message_t* fourth = pool.construct(4U);
+    TEST_CHECK(third == second);                        // last released, still warm in the cache
+    TEST_CHECK(fourth == first);
+    TEST_CHECK(!pool.owns(&third->payload[0]));         // not the start of a slot
+    TEST_CHECK(!pool.owns(&Message_t::numOfLive));
+
+    pool.destroy(third);
+    pool.destroy(fourth);
+}
+
+void testHandle(void) {
+    {
+        Pool<Message_t, 16U>::Handle_t handle = staticPool.create(7U);
+        TEST_CHECK(static_cast<bool>(handle));
+        TEST_EQUAL(7U, handle->id);
+        TEST_EQUAL(1, Message_t::numOfLive);
+
+        Pool<Message_t, 16U>::Handle_t moved = std::move(handle);
+        TEST_CHECK(!handle);
+        TEST_EQUAL(7U, (*moved).id);
+        TEST_EQUAL(1U, staticPool.getStats().inUse);
+    }
+    TEST_EQUAL(0, Message_t::numOfLive);
+    TEST_EQUAL(0U, staticPool.getStats().inUse);
+
+    Pool<Message_t, 16U>::Handle_t handle = staticPool.create(8U);
+    Message_t* message = handle.release();
+    TEST_CHECK(!handle);
+    TEST_EQUAL(1U, staticPool.getStats().inUse);
+    staticPool.destroy(message);
+    TEST_EQUAL(0U, staticPool.getStats().inUse);
+}
+
+void testHistogram(void) {
+    Pool<Message_t, 16U> pool;
+    Message_t* messages[16];
+
+    for(Message_t*& message : messages) {
+        message = pool.construct(0U);
+    }
+    // 8 buckets of 2 levels each, every level has been reached once
+    const Pool<Message_t, 16U>::Stats_t stats = pool.getStats();
+    for(uint32_t bucket = 0U; bucket < Pool<Message_t, 16U>::NumOfBuckets; bucket++) {
+        TEST_EQUAL(2U, stats.histogram[bucket]);
+    }
+    for(Message_t* message : messages) {
+        pool.destroy(message);
+    }
+}
+
+/// Threads take and give back slots concurrently, a slot handed out twice shows up as an overwritten owner
+void testConcurrentStress(void) {
+    constexpr uint32_t NumOfThreads = 8U;
+    constexpr uint32_t NumOfRounds = 100000U;
+    static Pool<std::atomic<uint32_t>, 32U> pool;
+    std::atomic<uint32_t> numOfCollisions{0U};
+    std::atomic<uint32_t> numOfServed{0U};
+
+    std::vector<std::thread> threads;
+    for(uint32_t thread = 0U; thread < NumOfThreads; thread++) {
+        threads.emplace_back([&, thread](void) {
+            std::atomic<uint32_t>* held[4] = {};
+            for(uint32_t round = 0U; round < NumOfRounds; round++) {
+                std::atomic<uint32_t>*& slot = held[round % 4U];
+                if(slot != nullptr) {
+                    if(slot->load(std::memory_order_relaxed) != (thread + 1U)) {
+                        numOfCollisions++;
+                    }
+                    pool.destroy(slot);
+                    slot = nullptr;
+                } else {
+                    slot = pool.construct(thread + 1U);
+                    numOfServed += (slot != nullptr) ? 1U : 0U;
+                }
+            }
+            for(std::atomic<uint32_t>* slot : held) {
+                pool.destroy(slot);
+            }
+        });
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const Pool<std::atomic<uint32_t>, 32U>::Stats_t stats = pool.getStats();
+    TEST_EQUAL(0U, numOfCollisions.load());
+    TEST_EQUAL(0U, stats.inUse);
+    TEST_CHECK(stats.peak <= 32U);
+    TEST_EQUAL(NumOfThreads * NumOfRounds / 2U, numOfServed.load() + stats.numOfFailures);
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"exhaustion", testExhaustion},
+        {"LIFO reuse", testLifoReuse},
+        {"handle", testHandle},
+        {"histogram", testHistogram},
+        {"concurrent stress", testConcurrentStress},
+    }));
+}
@@ -0,0 +1,157 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "scratcharena.h"
+#include "unittest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using mem::ScratchArena;
+
+namespace {
+
+bool isAligned(const void* ptr, std::size_t alignment) {
+    return ((reinterpret_cast<uintptr_t>(ptr) & (alignment - 1U)) == 0U);
+}
+
+void testBumpAndAlignment(void) {
+    mem::StaticScratchArena<256U> arena;
+
+    uint8_t* a = static_cast<uint8_t*>(arena.allocate(3U, 1U));
+    uint8_t* b = static_cast<uint8_t*>(arena.allocate(3U, 1U));
+    TEST_CHECK(b == (a + 3));                           // no header between allocations
+    double* c = arena.allocate<double>(2U);
+    TEST_CHECK(isAligned(c, alignof(double)));
+    void* d = arena.allocate(16U, 64U);
+    TEST_CHECK(isAligned(d, 64U));
+    TEST_EQUAL(256U, arena.getCapacity());
+    TEST_CHECK(arena.getUsed() >= 38U);
+}
+
+void testOverflow(void) {
+    mem::StaticScratchArena<64U> arena;
+
+    TEST_CHECK(arena.allocate(48U) != nullptr);
+    TEST_CHECK(arena.allocate(32U) == nullptr);
+    TEST_CHECK(arena.allocate<uint64_t>(static_cast<std::size_t>(-1) / 4U) == nullptr);    // size overflows
+    TEST_EQUAL(2U, arena.getNumOfOverflows());
+    TEST_CHECK(arena.allocate(16U, 1U) != nullptr);     // still usable
+    TEST_EQUAL(64U, arena.getUsed());
+    TEST_CHECK(arena.allocate(0U, 1U) != nullptr);
+    TEST_CHECK(arena.allocate(1U, 1U) == nullptr);
+}
+
+void testScopesAndPeak(void) {
+    mem::StaticScratchArena<1024U> arena;
+    TEST_CHECK(arena.allocate(100U, 1U) != nullptr);
+    {
+        ScratchArena::Scope_t scope(arena);
+        TEST_CHECK(arena.allocate(300U, 1U) != nullptr);
+        {
+            ScratchArena::Scope_t inner(arena);
+            TEST_CHECK(arena.allocate(200U, 1U) != nullptr);
+            TEST_EQUAL(600U, arena.getUsed());
+        }
+        TEST_EQUAL(400U, arena.getUsed());
+    }
+    TEST_EQUAL(100U, arena.getUsed());
+    TEST_EQUAL(600U, arena.getPeak());
+
+    arena.reset();
+    TEST_EQUAL(0U, arena.getUsed());
+    TEST_EQUAL(600U, arena.getPeak());
+}
+
+void testArenaAllocator(void) {
+    mem::StaticScratchArena<4096U> arena;
+    {
+        ScratchArena::Scope_t scope(arena);
+        std::vector<uint32_t, mem::ArenaAllocator<uint32_t>> values{mem::ArenaAllocator<uint32_t>(arena)};
+        values.reserve(64U);
+        for(uint32_t i = 0U; i < 64U; i++) {
+            values.push_back(i * i);
+        }
+        TEST_EQUAL(63U * 63U, values.back());
+        TEST_CHECK(arena.getUsed() >= (64U * sizeof(uint32_t)));
+
+        mem::ArenaAllocator<uint16_t> rebound(values.get_allocator());
+        TEST_CHECK(rebound == values.get_allocator());
+    }
+    TEST_EQUAL(0U, arena.getUsed());
+}
+
+/// One control cycle of temporaries: arena allocations and a reset against malloc/free of the same buffers
+void testCompareWithMalloc(void) {
+    using Clock_t = std::chrono::steady_clock;
+    constexpr uint32_t NumOfCycles = 20000U;
+    constexpr uint32_t NumOfBuffers = 16U;
+    mem::StaticScratchArena<16384U> arena;
+    void* buffers[NumOfBuffers];
+    uint32_t numOfFailures = 0U;
+
+    const Clock_t::time_point arenaStart = Clock_t::now();
+    for(uint32_t cycle = 0U; cycle < NumOfCycles; cycle++) {
+        for(uint32_t i = 0U; i < NumOfBuffers; i++) {
+            buffers[i] = arena.allocate(32U + ((cycle + i) % 16U) * 32U);
+            numOfFailures += (buffers[i] == nullptr) ? 1U : 0U;
+        }
+        static_cast<uint8_t*>(buffers[cycle % NumOfBuffers])[0] = 1U;
+        arena.reset();
+    }
+    const Clock_t::duration arenaTime = Clock_t::now() - arenaStart;
+
+    const Clock_t::time_point mallocStart = Clock_t::now();
+    for(uint32_t cycle = 0U; cycle < NumOfCycles; cycle++) {
+        for(uint32_t i = 0U; i < NumOfBuffers; i++) {
+            buffers[i] = std::malloc(32U + ((cycle + i) % 16U) * 32U);
+            numOfFailures += (buffers[i] == nullptr) ? 1U : 0U;
+        }
+        static_cast<uint8_t*>(buffers[cycle % NumOfBuffers])[0] = 1U;
+        for(void* buffer : buffers) {
+            std::free(buffer);
+        }
+    }
+    const Clock_t::duration mallocTime = Clock_t::now() - mallocStart;
+
+    TEST_EQUAL(0U, numOfFailures);
+    TEST_EQUAL(0U, arena.getNumOfOverflows());
+    std::printf("    arena:  %6.1f ns per cycle of %u buffers\n",
+                std::chrono::duration<double, std::nano>(arenaTime).count() / NumOfCycles, NumOfBuffers);
+    std::printf("    malloc: %6.1f ns per cycle of %u buffers\n",
+                std::chrono::duration<double, std::nano>(mallocTime).count() / NumOfCycles, NumOfBuffers);
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"bump and alignment", testBumpAndAlignment},
+        {"overflow", testOverflow},
+        {"scopes and peak", testScopesAndPeak},
+        {"arena allocator", testArenaAllocator},
+        {"compare with malloc", testCompareWithMalloc},
+    }));
+}
@@ -0,0 +1,388 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tlsf.h"
+#include "unittest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include <random>
+#include <utility>
+#include <vector>
+
+using mem::Tlsf;
+
+namespace {
+
+constexpr std::size_t ArenaSize = 100000U;
+
+alignas(Tlsf::Alignment) uint8_t arena[ArenaSize];
+alignas(Tlsf::Alignment) uint8_t secondArena[4096U];
+
+struct Allocation_t {
+    uint8_t* ptr;
+    std::size_t bytes;
+    uint8_t pattern;
+};
+
+void fill(const Allocation_t& allocation) {
+    std::memset(allocation.ptr, allocation.pattern, allocation.bytes);
+}
+
+bool isIntact(const Allocation_t& allocation) {
+    return (std::all_of(allocation.ptr, allocation.ptr + allocation.bytes,
+                        [&](uint8_t value) { return (value == allocation.pattern); }));
+}
+
+bool isAligned(const void* ptr, std::size_t alignment) {
+    return ((reinterpret_cast<uintptr_t>(ptr) & (alignment - 1U)) == 0U);
+}
+
+void testLargestFree(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+
+    // the free block is 99968 bytes natively, 99984 on the target: both are served from the 98304 class
+    const Tlsf::Stats_t stats = tlsf.getStats();
+    TEST_EQUAL(98304U, stats.largestFree);
+    TEST_EQUAL(0U, stats.usedBytes);
+    TEST_EQUAL(2U, stats.fragmentation);                // rounding to the class only, the arena is one block
+
+    void* largest = tlsf.allocate(stats.largestFree);
+    TEST_CHECK(largest != nullptr);
+    tlsf.release(largest);
+    TEST_CHECK(tlsf.allocate(stats.largestFree + Tlsf::Alignment) == nullptr);     // next class is empty
+    TEST_EQUAL(1U, tlsf.getStats().numOfFailures);
+}
+
+void testAllocateAndRelease(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+    const std::size_t largestFree = tlsf.getStats().largestFree;
+
+    void* a = tlsf.allocate(1U);
+    void* b = tlsf.allocate(100U);
+    void* c = tlsf.allocate(3000U);
+    TEST_CHECK((a != nullptr) && (b != nullptr) && (c != nullptr));
+    TEST_CHECK(isAligned(a, Tlsf::Alignment) && isAligned(b, Tlsf::Alignment) && isAligned(c, Tlsf::Alignment));
+    TEST_CHECK(Tlsf::getUsableSize(b) >= 100U);
+    TEST_CHECK(tlsf.owns(b));
+    TEST_CHECK(!tlsf.owns(secondArena));
+    TEST_EQUAL(3U, tlsf.getStats().numOfAllocations);
+
+    // released out of order, the neighbours merge back into one block
+    tlsf.release(b);
+    tlsf.release(a);
+    tlsf.release(c);
+    const Tlsf::Stats_t stats = tlsf.getStats();
+    TEST_EQUAL(0U, stats.numOfAllocations);
+    TEST_EQUAL(0U, stats.usedBytes);
+    TEST_EQUAL(largestFree, stats.largestFree);
+    TEST_CHECK(stats.peakBytes > 3100U);
+}
+
+void testSecondArena(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(secondArena, sizeof(secondArena)));
+    TEST_CHECK(!tlsf.addArena(secondArena, 8U));                    // too small for a block
+
+    void* small = tlsf.allocate(1024U);
+    TEST_CHECK(tlsf.owns(small));
+    TEST_CHECK(tlsf.allocate(8192U) == nullptr);
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+    void* large = tlsf.allocate(8192U);
+    TEST_CHECK((large >= static_cast<void*>(arena)) && (large < static_cast<void*>(arena + ArenaSize)));
+}
+
+void testAllocateAligned(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+    const std::size_t largestFree = tlsf.getStats().largestFree;
+
+    void* filler = tlsf.allocate(24U);                  // moves the free block off any large alignment
+    std::vector<void*> blocks;
+    for(std::size_t alignment : {16U, 32U, 64U, 256U, 1024U, 4096U}) {
+        void* ptr = tlsf.allocateAligned(alignment, 100U);
+        TEST_CHECK(ptr != nullptr);
+        TEST_CHECK(isAligned(ptr, alignment));
+        TEST_CHECK(Tlsf::getUsableSize(ptr) >= 100U);
+        std::memset(ptr, 0xA5, 100U);
+        blocks.push_back(ptr);
+    }
+    TEST_CHECK(tlsf.allocateAligned(24U, 100U) == nullptr);     // not a power of two
+
+    tlsf.release(filler);
+    for(void* ptr : blocks) {
+        tlsf.release(ptr);
+    }
+    // the padding blocks merge back as well
+    TEST_EQUAL(0U, tlsf.getStats().usedBytes);
+    TEST_EQUAL(largestFree, tlsf.getStats().largestFree);
+}
+
+void testShrinkInPlace(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+
+    uint8_t* ptr = static_cast<uint8_t*>(tlsf.allocate(4096U));
+    void* behind = tlsf.allocate(64U);                  // successor is used, the tail becomes a block of its own
+    std::memset(ptr, 0x5A, 4096U);
+    const std::size_t used = tlsf.getStats().usedBytes;
+
+    TEST_CHECK(tlsf.reallocate(ptr, 1024U) == ptr);
+    TEST_EQUAL(1024U, Tlsf::getUsableSize(ptr));
+    TEST_EQUAL(used - 3072U, tlsf.getStats().usedBytes);
+    TEST_CHECK(std::all_of(ptr, ptr + 1024U, [](uint8_t value) { return (value == 0x5AU); }));
+
+    void* tail = tlsf.allocate(2048U);                  // the released tail serves it
+    TEST_CHECK((tail > static_cast<void*>(ptr)) && (tail < behind));
+
+    TEST_CHECK(tlsf.reallocate(ptr, 1020U) == ptr);     // less than a block: stays as it is
+    TEST_EQUAL(1024U, Tlsf::getUsableSize(ptr));
+}
+
+void testGrowInPlaceAndMove(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+
+    uint8_t* ptr = static_cast<uint8_t*>(tlsf.allocate(256U));
+    std::memset(ptr, 0x3C, 256U);
+    TEST_CHECK(tlsf.reallocate(ptr, 2048U) == ptr);     // free successor
+    TEST_CHECK(Tlsf::getUsableSize(ptr) >= 2048U);
+
+    void* behind = tlsf.allocate(64U);
+    uint8_t* moved = static_cast<uint8_t*>(tlsf.reallocate(ptr, 4096U));
+    TEST_CHECK((moved != nullptr) && (moved != ptr));
+    TEST_CHECK(std::all_of(moved, moved + 256U, [](uint8_t value) { return (value == 0x3CU); }));
+    TEST_EQUAL(2U, tlsf.getStats().numOfAllocations);
+
+    TEST_CHECK(tlsf.reallocate(moved, 0U) == nullptr);  // releases
+    tlsf.release(behind);
+    TEST_EQUAL(0U, tlsf.getStats().usedBytes);
+}
+
+/// Random allocate/reallocate/release against a shadow of the live blocks, contents must never be overwritten
+void testStress(void) {
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+    TEST_CHECK(tlsf.addArena(secondArena, sizeof(secondArena)));
+    const std::size_t largestFree = tlsf.getStats().largestFree;
+
+    std::mt19937 random{4711U};
+    std::vector<Allocation_t> live;
+    uint32_t numOfCorruptions = 0U;
+    uint32_t numOfServed = 0U;
+
+    for(uint32_t i = 0U; i < 200000U; i++) {
+        const uint32_t action = random() % 8U;
+        if((action < 4U) || live.empty()) {
+            const std::size_t bytes = (random() % 4U == 0U) ? (1U + random() % 4000U) : (1U + random() % 64U);
+            void* ptr = ((action & 1U) != 0U) ? tlsf.allocateAligned(std::size_t{32} << (random() % 4U), bytes)
+                                              : tlsf.allocate(bytes);
+            if(ptr != nullptr) {
+                live.push_back({static_cast<uint8_t*>(ptr), bytes, static_cast<uint8_t>(random())});
+                fill(live.back());
+                numOfServed++;
+            }
+        } else {
+            const std::size_t index = random() % live.size();
+            Allocation_t& allocation = live[index];
+            if(!isIntact(allocation)) {
+                numOfCorruptions++;
+            }
+            if(action == 7U) {
+                const std::size_t bytes = 1U + random() % 2000U;
+                void* ptr = tlsf.reallocate(allocation.ptr, bytes);
+                if(ptr != nullptr) {
+                    allocation.ptr = static_cast<uint8_t*>(ptr);
+                    allocation.bytes = std::min(allocation.bytes, bytes);
+                    TEST_CHECK(isIntact(allocation));
+                    allocation.bytes = bytes;
+                    fill(allocation);
+                }
+            } else {
+                tlsf.release(allocation.ptr);
+                live[index] = live.back();
+                live.pop_back();
+            }
+        }
+    }
+
+    std::size_t usedBytes = 0U;
+    for(const Allocation_t& allocation : live) {
+        numOfCorruptions += isIntact(allocation) ? 0U : 1U;
+        usedBytes += Tlsf::getUsableSize(allocation.ptr);
+    }
+    TEST_EQUAL(0U, numOfCorruptions);
+    TEST_CHECK(numOfServed > 50000U);
+    TEST_EQUAL(live.size(), static_cast<std::size_t>(tlsf.getStats().numOfAllocations));
+    TEST_EQUAL(usedBytes + live.size() * 2U * sizeof(void*), tlsf.getStats().usedBytes);
+
+    for(const Allocation_t& allocation : live) {
+        tlsf.release(allocation.ptr);
+    }
+    TEST_EQUAL(0U, tlsf.getStats().usedBytes);
+    TEST_EQUAL(largestFree, tlsf.getStats().largestFree);      // everything merged again
+}
+
+/// Prints the latency percentiles of one allocator and the free space between its live blocks
+void printResult(const char* name, std::vector<double>& latencyNs,
+                 std::vector<std::pair<uintptr_t, std::size_t>>& live) {
+    std::sort(latencyNs.begin(), latencyNs.end());
+    auto percentile = [&](double fraction) {
+        return (latencyNs[static_cast<std::size_t>(fraction * static_cast<double>(latencyNs.size() - 1U))]);
+    };
+    std::printf("    %-7s p50 %6.1f ns, p90 %6.1f ns, p99 %6.1f ns, p99.9 %7.1f ns, max %8.1f ns\n", name,
+                percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999), latencyNs.back());
+
+    // Both allocators are measured the same way: the gaps between the live blocks (including the headers of the
+    // following blocks) are the free space inside the footprint, the largest gap is the largest block a request
+    // could get without growing the footprint
+    if(live.empty()) {
+        return;
+    }
+    std::sort(live.begin(), live.end());
+    std::size_t liveBytes = 0U;
+    std::size_t freeBytes = 0U;
+    std::size_t largestHole = 0U;
+    for(std::size_t i = 0U; i < live.size(); i++) {
+        liveBytes += live[i].second;
+        if((i + 1U) < live.size()) {
+            const std::size_t hole = live[i + 1U].first - (live[i].first + live[i].second);
+            freeBytes += hole;
+            largestHole = std::max(largestHole, hole);
+        }
+    }
+    const std::size_t footprint = live.back().first + live.back().second - live.front().first;
+    std::printf("    %-7s %zu live blocks, %zu of %zu bytes live, largest hole %zu of %zu free bytes "
+                "(fragmentation %zu %%)\n", name, live.size(), liveBytes, footprint, largestHole, freeBytes,
+                (freeBytes == 0U) ? std::size_t{0U} : 100U - (largestHole * 100U) / freeBytes);
+}
+
+/// Same request sequence for TLSF and the host malloc, reports the latency percentiles of an allocate/release and
+/// the fragmentation with the slots of the end of the sequence still live
+void testCompareWithMalloc(void) {
+    using Clock_t = std::chrono::steady_clock;
+
+    constexpr uint32_t NumOfSlots = 256U;
+    constexpr uint32_t NumOfOps = 200000U;
+    std::vector<std::size_t> sizes(NumOfOps);
+    std::vector<uint32_t> slots(NumOfOps);
+    std::mt19937 random{42U};
+    for(uint32_t i = 0U; i < NumOfOps; i++) {
+        // Mostly small objects, every 8th request a buffer of up to 2 KiB
+        sizes[i] = ((random() % 8U) == 0U) ? (8U + random() % 2048U) : (8U + random() % 256U);
+        slots[i] = random() % NumOfSlots;
+    }
+
+    // The vectors are reserved before the runs so that they don't interleave with the blocks of malloc
+    std::vector<double> latencyNs;
+    latencyNs.reserve(NumOfOps);
+    std::vector<std::pair<uintptr_t, std::size_t>> liveBlocks;
+    liveBlocks.reserve(NumOfSlots);
+
+    auto run = [&](auto allocate, auto release, auto usableSize) {
+        std::vector<void*> live(NumOfSlots, nullptr);
+        std::vector<std::size_t> requested(NumOfSlots, 0U);
+        latencyNs.clear();
+        uint32_t numOfFailures = 0U;
+        for(uint32_t i = 0U; i < NumOfOps; i++) {
+            void*& slot = live[slots[i]];
+            const Clock_t::time_point start = Clock_t::now();
+            if(slot != nullptr) {
+                release(slot);
+                slot = nullptr;
+            } else {
+                slot = allocate(sizes[i]);
+                numOfFailures += (slot == nullptr) ? 1U : 0U;
+            }
+            requested[slots[i]] = sizes[i];
+            latencyNs.push_back(std::chrono::duration<double, std::nano>(Clock_t::now() - start).count());
+        }
+        TEST_EQUAL(0U, numOfFailures);
+
+        liveBlocks.clear();
+        for(uint32_t slot = 0U; slot < NumOfSlots; slot++) {
+            if(live[slot] != nullptr) {
+                liveBlocks.emplace_back(reinterpret_cast<uintptr_t>(live[slot]),
+                                        usableSize(live[slot], requested[slot]));
+            }
+        }
+        TEST_CHECK(liveBlocks.size() > 1U);
+        return (live);
+    };
+
+#if defined(__GLIBC__)
+    // Keep the 2 KiB buffers on the heap of malloc like the TLSF arena
+    mallopt(M_MMAP_THRESHOLD, 1024 * 1024);
+#endif
+
+    Tlsf tlsf;
+    TEST_CHECK(tlsf.addArena(arena, ArenaSize));
+    std::vector<void*> live = run([&](std::size_t bytes) { return (tlsf.allocate(bytes)); },
+                                  [&](void* ptr) { tlsf.release(ptr); },
+                                  [](void* ptr, std::size_t) { return (Tlsf::getUsableSize(ptr)); });
+    const Tlsf::Stats_t stats = tlsf.getStats();
+    printResult("tlsf:", latencyNs, liveBlocks);
+    std::printf("    tlsf:   largestFree %zu bytes (including the free tail of the arena), fragmentation %u %%\n",
+                stats.largestFree, static_cast<unsigned>(stats.fragmentation));
+    for(void* ptr : live) {
+        tlsf.release(ptr);
+    }
+    TEST_EQUAL(0U, tlsf.getStats().usedBytes);
+
+    live = run([](std::size_t bytes) { return (std::malloc(bytes)); }, [](void* ptr) { std::free(ptr); },
+#if defined(__GLIBC__)
+               [](void* ptr, std::size_t) { return (malloc_usable_size(ptr)); });
+#else
+               [](void*, std::size_t bytes) { return (bytes); });
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+    // The allocator of ASan spreads the blocks over size class regions, the gaps say nothing about malloc
+    liveBlocks.clear();
+#endif
+    printResult("malloc:", latencyNs, liveBlocks);
+    for(void* ptr : live) {
+        std::free(ptr);
+    }
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"largest free", testLargestFree},
+        {"allocate and release", testAllocateAndRelease},
+        {"second arena", testSecondArena},
+        {"allocate aligned", testAllocateAligned},
+        {"shrink in place", testShrinkInPlace},
+        {"grow in place and move", testGrowInPlaceAndMove},
+        {"stress", testStress},
+        {"compare with malloc", testCompareWithMalloc},
+    }));
+}
@@ -0,0 +1,75 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace diag {
+
+/**
+ * @brief High-water mark of the main stack.
+ * 
+ * The startup code paints the reserved main stack [_sstack, _estack) with Pattern (build option STACK_PAINT).
+ * Main and all ISRs run on the main stack, so the high-water mark covers both. poll() scans incrementally with
+ * a fixed budget per call and is meant for the idle loop, scan() walks the whole painted area at once.
+ */
+class StackMonitor {
+public:
+    static constexpr uint32_t Pattern       = 0xA5A5A5A5U;      ///< Must match the pattern in the startup code
+    static constexpr uint32_t DefaultBudget = 16U;              ///< Words checked per poll()
+
+    StackMonitor(void) = delete;
+
+    /**
+     * @brief Returns the size of the reserved main stack in bytes.
+     */
+    static uint32_t getSize(void);
+
+    /**
+     * @brief Returns the maximum stack usage in bytes found by the previous scans.
+     */
+    static uint32_t getHighWater(void);
+
+    /**
+     * @brief Checks up to budget words of the painted area for a new high-water mark.
+     * 
+     * @return true if the high-water mark increased
+     */
+    static bool poll(uint32_t budget = DefaultBudget);
+
+    /**
+     * @brief Scans the painted area completely and returns the high-water mark in bytes.
+     */
+    static uint32_t scan(void);
+
+    /**
+     * @brief Returns true if the lowest word of the reserved stack has been overwritten.
+     */
+    static bool isOverflowed(void);
+
+private:
+    static inline const uint32_t* _cursor{nullptr};     ///< Next word to check by poll()
+    static inline const uint32_t* _mark{nullptr};       ///< Deepest used word found so far
+};
+
+}   // namespace diag
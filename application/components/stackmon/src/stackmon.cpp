@@ -0,0 +1,96 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "stackmon.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+// Limits of the reserved main stack, defined by the linker script
+extern "C" uint32_t _sstack;
+extern "C" uint32_t _estack;
+
+namespace {
+
+inline const uint32_t* bottom(void) {
+    return (&_sstack);
+}
+
+inline const uint32_t* top(void) {
+    return (&_estack);
+}
+
+}   // anonymous namespace
+
+namespace diag {
+
+uint32_t StackMonitor::getSize(void) {
+    return (static_cast<uint32_t>(top() - bottom()) * sizeof(uint32_t));
+}
+
+uint32_t StackMonitor::getHighWater(void) {
+    if(_mark == nullptr) {
+        return (0U);
+    }
+    return (static_cast<uint32_t>(top() - _mark) * sizeof(uint32_t));
+}
+
+bool StackMonitor::poll(uint32_t budget) {
+    const uint32_t* mark = (_mark != nullptr) ? _mark : top();
+    const uint32_t* cursor = (_cursor != nullptr) ? _cursor : bottom();
+
+    // The stack grows down, the first overwritten word from the bottom is the deepest one. Each call continues
+    // where the previous one stopped and restarts at the bottom once it reaches the current mark.
+    for(; budget > 0U; budget--) {
+        if(cursor >= mark) {
+            _cursor = bottom();
+            return (false);
+        }
+        if(*cursor != Pattern) {
+            _mark = cursor;
+            _cursor = bottom();
+            return (true);
+        }
+        cursor++;
+    }
+    _cursor = cursor;
+    return (false);
+}
+
+uint32_t StackMonitor::scan(void) {
+    const uint32_t* mark = (_mark != nullptr) ? _mark : top();
+    const uint32_t* cursor = bottom();
+
+    while((cursor < mark) && (*cursor == Pattern)) {
+        cursor++;
+    }
+    if(cursor < mark) {
+        _mark = cursor;
+    }
+    _cursor = bottom();
+    return (getHighWater());
+}
+
+bool StackMonitor::isOverflowed(void) {
+    return (*bottom() != Pattern);
+}
+
+}   // namespace diag
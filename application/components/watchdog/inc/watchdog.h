@@ -0,0 +1,191 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+#include "stm32g474xx_regs.h"
+
+namespace diag {
+
+/**
+ * @brief Independent and window watchdog service with per-task liveness tracking.
+ * 
+ * Every task or loop registered with add() has to call checkIn() at least once within its deadline, given in check
+ * periods. check() runs once per check period, e.g. from the main loop or a timer: it evaluates all deadlines in one
+ * pass and kicks the watchdogs only while every task is alive. A task that missed its deadline is recorded in
+ * .noinit before the kicks stop, so after the watchdog reset takeMiss() tells which task it was. The window
+ * watchdog early wakeup interrupt records a missing kick (e.g. check() itself is stuck) the same way.
+ *
+ * checkIn() is a single byte store and kick() a flag test plus one store per watchdog, both can be called from
+ * interrupts. A check-in that happens while check() clears the flag of the task may count for the current period
+ * only, so deadlines should cover at least two check-in intervals.
+ */
+class Watchdog {
+public:
+    using TaskId_t = uint8_t;
+
+    static constexpr uint32_t MaxTasks          = 16U;
+    static constexpr TaskId_t InvalidTask       = 0xFFU;
+    static constexpr uint32_t MissMagic         = 0x57D0AB1EU;
+    static constexpr uint32_t LsiFrequency      = 32000U;       ///< IWDG clock in Hz
+    static constexpr uint32_t IwdgMaxReload     = 0xFFFU;
+    static constexpr uint32_t IwdgMaxPrescaler  = 6U;           ///< PR encoding of /256
+    static constexpr uint32_t DefaultCheckPeriodMs = 10U;
+
+    static constexpr uint32_t KeyReload         = 0xAAAAU;
+    static constexpr uint32_t KeyUnlock         = 0x5555U;
+    static constexpr uint32_t KeyStart          = 0xCCCCU;
+
+    struct IwdgConfig_t {
+        uint8_t prescaler;      ///< PR encoding, the IWDG counts with LSI / (4 << prescaler)
+        uint16_t reload;
+    };
+
+    /// Record of the task that stopped the kicks, kept in .noinit across the watchdog reset
+    struct Miss_t {
+        uint32_t magic;
+        TaskId_t task;          ///< First task that missed, InvalidTask if the kicks stopped without a miss
+        const char* name;       ///< Name of that task, nullptr for InvalidTask
+        uint32_t missed;        ///< Bit mask of all tasks over their deadline
+        uint32_t resetFlags;    ///< RCC_CSR of the reset that followed, filled in by takeMiss()
+    };
+
+    Watchdog(void) = delete;
+
+    /**
+     * @brief Prescaler and reload value of the IWDG for the given timeout, the prescaler is as small as possible.
+     */
+    static constexpr IwdgConfig_t getIwdgConfig(uint32_t timeoutMs) {
+        uint8_t prescaler = 0U;
+        while((prescaler < IwdgMaxPrescaler) &&
+              (((static_cast<uint64_t>(timeoutMs) * LsiFrequency) / (1000U * (4U << prescaler))) > IwdgMaxReload)) {
+            prescaler++;
+        }
+        const uint64_t ticks = (static_cast<uint64_t>(timeoutMs) * LsiFrequency) / (1000U * (4U << prescaler));
+        const uint16_t reload = (ticks > IwdgMaxReload) ? IwdgMaxReload : ((ticks == 0U) ? 0U : (ticks - 1U));
+        return (IwdgConfig_t{prescaler, reload});
+    }
+
+    /**
+     * @brief Registers a task that has to check in at least every deadline check periods.
+     * 
+     * @return id for checkIn(), InvalidTask if MaxTasks are registered
+     */
+    static TaskId_t add(const char* name, uint16_t deadline);
+
+    /**
+     * @brief Starts the independent watchdog, it can not be stopped again. Both watchdogs are frozen while the core
+     * is halted by a debugger.
+     */
+    static void startIndependent(IwdgConfig_t config);
+
+    /**
+     * @brief Starts the window watchdog with its early wakeup interrupt. It counts with PCLK1 / 4096 / 2^prescaler
+     * from counter (0x40..0x7F) down and resets at 0x3F or if kicked while the counter is above window, so check()
+     * has to run in that window.
+     */
+    static void startWindow(uint8_t prescaler, uint8_t window, uint8_t counter);
+
+    /**
+     * @brief Liveness check-in of a task.
+     */
+    static void checkIn(TaskId_t task) {
+        _checkIns[task] = 1U;
+    }
+
+    /**
+     * @brief Evaluates the deadlines of all tasks and kicks the watchdogs if all are alive. Once a task missed, the
+     * miss is recorded and the watchdogs are not kicked anymore.
+     * 
+     * @return true if all tasks are alive
+     */
+    static bool check(void);
+
+    /**
+     * @brief Calls check() once per check period and returns the current health otherwise, for loops that run
+     * faster than the check period. The period is measured with the DWT cycle counter and SystemCoreClock.
+     */
+    static bool poll(void);
+
+    /**
+     * @brief Sets the check period of poll(), the deadlines of add() are multiples of it.
+     */
+    static void setCheckPeriod(uint32_t periodMs) {
+        _checkPeriodMs = periodMs;
+    }
+
+    /**
+     * @brief Reloads the running watchdogs while all tasks are alive.
+     */
+    static void kick(void) {
+        if(_healthy) {
+            Iwdg::Kr::write(Iwdg::Kr::Key::value<KeyReload>());
+            if(_wwdgCounter != 0U) {
+                Wwdg::Cr::write(Wwdg::Cr::T::value(_wwdgCounter), Wwdg::Cr::Wdga::set());
+            }
+        }
+    }
+
+    static bool isHealthy(void) {
+        return (_healthy);
+    }
+
+    /**
+     * @brief Copies the miss record of a watchdog reset and clears it.
+     * 
+     * The reset flags of RCC_CSR have to be cleared after every boot (FaultManager::clearResetFlags()), otherwise
+     * the flags of an earlier watchdog reset make a later reset look like one.
+     * 
+     * @return false if the last reset was no watchdog reset or nothing was recorded
+     */
+    static bool takeMiss(Miss_t& miss);
+
+    /**
+     * @brief Records the missing kick of the window watchdog, called by WWDG_IRQHandler.
+     */
+    static void onEarlyWakeup(void);
+
+private:
+    using Iwdg = mcal::stm32g4::Iwdg;
+    using Wwdg = mcal::stm32g4::Wwdg;
+
+    static void recordMiss(TaskId_t task, uint32_t missed);
+
+    static inline volatile uint8_t _checkIns[MaxTasks]{};
+    static inline uint16_t _deadlines[MaxTasks]{};
+    static inline uint16_t _remaining[MaxTasks]{};      ///< Check periods left until the deadline
+    static inline const char* _names[MaxTasks]{};
+    static inline uint32_t _numOfTasks{0U};
+    static inline volatile bool _healthy{true};
+    static inline uint8_t _wwdgCounter{0U};             ///< Reload value of the window watchdog, 0 if not running
+    static inline uint32_t _checkPeriodMs{DefaultCheckPeriodMs};
+    static inline uint32_t _lastCheck{0U};              ///< DWT cycle count of the last check() of poll()
+};
+
+static_assert(Watchdog::MaxTasks <= 32U, "missed tasks are a 32 bit mask");
+static_assert(Watchdog::getIwdgConfig(1000U).prescaler == 1U, "1 s: LSI / 8");
+static_assert(Watchdog::getIwdgConfig(1000U).reload == 3999U, "1 s: 4000 ticks of 250 us");
+static_assert(Watchdog::getIwdgConfig(100000U).reload == Watchdog::IwdgMaxReload, "longer than 32.7 s is clamped");
+
+}   // namespace diag
@@ -0,0 +1,151 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "watchdog.h"		// Include own header first because it needs to compile in isolation
+
+#include "stm32g4xx.h"
+#include "memmap.h"
+
+NOINIT diag::Watchdog::Miss_t g_watchdogMiss;      // survives the watchdog reset
+
+namespace {
+
+using mcal::stm32g4::Dbgmcu;
+using mcal::stm32g4::Rcc;
+
+constexpr uint8_t WwdgMinCounter = 0x40U;   ///< The window watchdog resets when T6 gets cleared
+
+}   // anonymous namespace
+
+namespace diag {
+
+Watchdog::TaskId_t Watchdog::add(const char* name, uint16_t deadline) {
+    if(_numOfTasks >= MaxTasks) {
+        return (InvalidTask);
+    }
+    const TaskId_t task = static_cast<TaskId_t>(_numOfTasks);
+    _names[task] = name;
+    _deadlines[task] = deadline;
+    _remaining[task] = deadline;
+    _checkIns[task] = 0U;
+    _numOfTasks++;
+    return (task);
+}
+
+void Watchdog::startIndependent(IwdgConfig_t config) {
+    Dbgmcu::Apb1fzr1::modify(Dbgmcu::Apb1fzr1::DbgIwdgStop::set());
+    Iwdg::Kr::write(Iwdg::Kr::Key::value<KeyStart>());
+    Iwdg::Kr::write(Iwdg::Kr::Key::value<KeyUnlock>());
+    Iwdg::Pr::write(Iwdg::Pr::PrField::value(config.prescaler));
+    Iwdg::Rlr::write(Iwdg::Rlr::Rl::value(config.reload));
+    while(Iwdg::Sr::read() != 0U) {}                // prescaler and reload are taken over in the LSI domain
+    Iwdg::Kr::write(Iwdg::Kr::Key::value<KeyReload>());
+}
+
+void Watchdog::startWindow(uint8_t prescaler, uint8_t window, uint8_t counter) {
+    Rcc::Apb1enr1::modify(Rcc::Apb1enr1::Wwdgen::set());
+    Dbgmcu::Apb1fzr1::modify(Dbgmcu::Apb1fzr1::DbgWwdgStop::set());
+    Wwdg::Cfr::write(Wwdg::Cfr::W::value(window), Wwdg::Cfr::Wdgtb::value(prescaler), Wwdg::Cfr::Ewi::set());
+    Wwdg::Sr::write(Wwdg::Sr::Ewif::clear());
+    NVIC_ClearPendingIRQ(WWDG_IRQn);
+    NVIC_EnableIRQ(WWDG_IRQn);
+    _wwdgCounter = (counter < WwdgMinCounter) ? WwdgMinCounter : (counter & 0x7FU);
+    Wwdg::Cr::write(Wwdg::Cr::T::value(_wwdgCounter), Wwdg::Cr::Wdga::set());
+}
+
+bool Watchdog::check(void) {
+    if(!_healthy) {
+        return (false);
+    }
+
+    uint32_t missed = 0U;
+    TaskId_t first = InvalidTask;
+    for(uint32_t task = 0U; task < _numOfTasks; task++) {
+        if(_checkIns[task] != 0U) {
+            _checkIns[task] = 0U;
+            _remaining[task] = _deadlines[task];
+        } else if(_remaining[task] > 0U) {
+            _remaining[task]--;
+        } else {
+            missed |= (1UL << task);
+            if(first == InvalidTask) {
+                first = static_cast<TaskId_t>(task);
+            }
+        }
+    }
+
+    if(missed != 0U) {
+        recordMiss(first, missed);
+        _healthy = false;
+        return (false);
+    }
+    kick();
+    return (true);
+}
+
+bool Watchdog::poll(void) {
+    const uint32_t now = DWT->CYCCNT;
+    const uint32_t period = (SystemCoreClock / 1000U) * _checkPeriodMs;    // follows clock switches
+    if((now - _lastCheck) < period) {
+        return (_healthy);
+    }
+    _lastCheck = now;
+    return (check());
+}
+
+bool Watchdog::takeMiss(Miss_t& miss) {
+    const uint32_t flags = Rcc::Csr::read() & (Rcc::Csr::Iwdgrstf::Mask | Rcc::Csr::Wwdgrstf::Mask);
+    const bool valid = (g_watchdogMiss.magic == MissMagic) && (flags != 0U);
+
+    if(valid) {
+        miss = g_watchdogMiss;
+        miss.resetFlags = flags;
+    }
+    g_watchdogMiss.magic = 0U;
+    return (valid);
+}
+
+void Watchdog::onEarlyWakeup(void) {
+    Wwdg::Sr::write(Wwdg::Sr::Ewif::clear());
+    if(_healthy) {
+        // all tasks alive but check() did not kick in time, e.g. a stuck loop that also runs check()
+        recordMiss(InvalidTask, 0U);
+        _healthy = false;
+    }
+}
+
+void Watchdog::recordMiss(TaskId_t task, uint32_t missed) {
+    g_watchdogMiss.task = task;
+    g_watchdogMiss.name = (task != InvalidTask) ? _names[task] : nullptr;
+    g_watchdogMiss.missed = missed;
+    g_watchdogMiss.resetFlags = 0U;
+    g_watchdogMiss.magic = MissMagic;
+}
+
+}   // namespace diag
+
+/**
+ * @brief Early wakeup of the window watchdog, the counter reached 0x40 and the reset follows within one WWDG tick.
+ */
+extern "C" void WWDG_IRQHandler(void) {
+    diag::Watchdog::onEarlyWakeup();
+}
@@ -0,0 +1,221 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Routes the C and C++ heap to the TLSF system heap (mem::Heap) instead of newlib's malloc on top of _sbrk.
+// newlib calls the reentrant _r variants internally, both sets are replaced.
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <reent.h>
+
+#include "heap.h"
+
+namespace {
+
+void* allocateZeroed(std::size_t count, std::size_t size) {
+    if((size != 0U) && (count > (static_cast<std::size_t>(-1) / size))) {
+        return (nullptr);
+    }
+    void* ptr = mem::Heap::allocate(count * size);
+    if(ptr != nullptr) {
+        std::memset(ptr, 0, count * size);
+    }
+    return (ptr);
+}
+
+void* allocateOrAbort(std::size_t size) {
+    void* ptr = mem::Heap::allocate(size);
+    if(ptr == nullptr) {
+        std::abort();       // built without exceptions, std::bad_alloc can not be thrown
+    }
+    return (ptr);
+}
+
+void* allocateAlignedOrAbort(std::size_t size, std::align_val_t alignment) {
+    void* ptr = mem::Heap::allocateAligned(static_cast<std::size_t>(alignment), size);
+    if(ptr == nullptr) {
+        std::abort();
+    }
+    return (ptr);
+}
+
+}   // anonymous namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    void* ptr = mem::Heap::allocate(size);
+    if(ptr == nullptr) {
+        errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void free(void* ptr) {
+    mem::Heap::release(ptr);
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = allocateZeroed(count, size);
+    if(ptr == nullptr) {
+        errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void* realloc(void* ptr, size_t size) {
+    void* moved = mem::Heap::reallocate(ptr, size);
+    if((moved == nullptr) && (size != 0U)) {
+        errno = ENOMEM;
+    }
+    return (moved);
+}
+
+void* _malloc_r(struct _reent* reent, size_t size) {
+    void* ptr = mem::Heap::allocate(size);
+    if(ptr == nullptr) {
+        reent->_errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void _free_r(struct _reent* reent, void* ptr) {
+    (void)reent;
+    mem::Heap::release(ptr);
+}
+
+void* _calloc_r(struct _reent* reent, size_t count, size_t size) {
+    void* ptr = allocateZeroed(count, size);
+    if(ptr == nullptr) {
+        reent->_errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void* _realloc_r(struct _reent* reent, void* ptr, size_t size) {
+    void* moved = mem::Heap::reallocate(ptr, size);     // shrinks in place
+    if((moved == nullptr) && (size != 0U)) {
+        reent->_errno = ENOMEM;
+    }
+    return (moved);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* ptr = mem::Heap::allocateAligned(alignment, size);
+    if(ptr == nullptr) {
+        errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void* _memalign_r(struct _reent* reent, size_t alignment, size_t size) {
+    void* ptr = mem::Heap::allocateAligned(alignment, size);
+    if(ptr == nullptr) {
+        reent->_errno = ENOMEM;
+    }
+    return (ptr);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return (memalign(alignment, size));
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    if((alignment < sizeof(void*)) || ((alignment & (alignment - 1U)) != 0U)) {
+        return (EINVAL);
+    }
+    void* aligned = mem::Heap::allocateAligned(alignment, size);
+    if(aligned == nullptr) {
+        return (ENOMEM);
+    }
+    *ptr = aligned;
+    return (0);
+}
+
+}   // extern "C"
+
+void* operator new(std::size_t size) {
+    return (allocateOrAbort(size));
+}
+
+void* operator new[](std::size_t size) {
+    return (allocateOrAbort(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return (mem::Heap::allocate(size));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return (mem::Heap::allocate(size));
+}
+
+void operator delete(void* ptr) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    mem::Heap::release(ptr);
+}
+
+// Over-aligned types (alignof > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return (allocateAlignedOrAbort(size, alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return (allocateAlignedOrAbort(size, alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return (mem::Heap::allocateAligned(static_cast<std::size_t>(alignment), size));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return (mem::Heap::allocateAligned(static_cast<std::size_t>(alignment), size));
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    mem::Heap::release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    mem::Heap::release(ptr);
+}
@@ -22,12 +22,39 @@
 
 #include <cstdint>
 #include "BSP_setup.h"
+#include "boot_profile.h"
+#include "clockctrl.h"
+#include "crashdump.h"
+#include "fault.h"
+#include "stackmon.h"
+#include "watchdog.h"
+
+static BootReport_t bootReport;		// boot phase durations, inspect with the debugger
+static diag::CrashDump::Record_t crashRecord;	// fault record of the previous run, decode with tools/crashdump.py
+static bool crashed;
+static bool warmBoot;					// started by a warm reset of the fault manager
+static diag::Watchdog::Miss_t watchdogMiss;	// task that missed its deadline before the last watchdog reset
+static bool watchdogReset;
 
 int main(void)
 {
+	crashed = diag::CrashDump::take(crashRecord);
+	warmBoot = diag::FaultManager::init();	// slow init paths can be skipped on a warm boot
 	BSP_HWSetup();
-
-	for(;;) {}
+	mcal::ClockController::refresh();		// prime the frequency cache, clock switches invalidate it (SystemCoreClockChanged)
+	BootProfile_Mark(BOOT_PHASE_MAIN);
+	BootProfile_Report(&bootReport);
+
+	watchdogReset = diag::Watchdog::takeMiss(watchdogMiss);
+	diag::FaultManager::clearResetFlags();	// after all readers, else the next boot sees stale causes
+	const diag::Watchdog::TaskId_t mainLoop = diag::Watchdog::add("main", 1U);
+	diag::Watchdog::startIndependent(diag::Watchdog::getIwdgConfig(100U));
+
+	for(;;) {
+		diag::StackMonitor::poll();		// high-water mark of the main stack, see getHighWater()
+		diag::Watchdog::checkIn(mainLoop);
+		diag::Watchdog::poll();			// check() once per check period (10 ms)
+	}
 
 	return 0;
 }
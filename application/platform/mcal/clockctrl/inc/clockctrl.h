@@ -22,8 +22,167 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 namespace  mcal {
-    class ClockController {
-        
+
+/**
+ * @brief Interface of components that depend on the clock frequencies (e.g. baud rate or timer divisors).
+ */
+class IClockListener {
+public:
+    virtual ~IClockListener(void) = default;
+
+    /**
+     * @brief Called after the clock tree changed. May be called from NMI context (clock security system).
+     */
+    virtual void onClockChange(void) = 0;
+};
+
+/**
+ * @brief Clock tree query and control service.
+ * 
+ * Bus and kernel clock frequencies are derived from the RCC registers once and kept in a cache.
+ * Drivers computing baud rate or timer divisors therefore only pay for a memory load. The cache
+ * has to be invalidated whenever the clock tree is reconfigured; the next query re-reads RCC.
+ *
+ * invalidate() may interrupt refresh() (CSS NMI): it advances a generation counter, and refresh()
+ * only marks the cache valid for the generation it started in, so frequencies read before the
+ * clock change are never published as current.
+ */
+class ClockController {
+public:
+    enum class Bus_t : uint8_t {
+        SYSCLK = 0,         ///< System clock
+        HCLK,               ///< AHB clock (core clock)
+        PCLK1,              ///< APB1 peripheral clock
+        PCLK2,              ///< APB2 peripheral clock
+        TIMPCLK1,           ///< APB1 timer clock (x2 if APB1 prescaler != 1)
+        TIMPCLK2,           ///< APB2 timer clock (x2 if APB2 prescaler != 1)
+        NumOfBusses
+    };
+
+    enum class KernelClock_t : uint8_t {
+        Usart1 = 0,
+        Usart2,
+        Usart3,
+        Uart4,
+        Uart5,
+        LpUart1,
+        I2c1,
+        I2c2,
+        I2c3,
+        I2c4,
+        LpTim1,
+        Adc12,
+        Adc345,
+        NumOfKernelClocks
+    };
+
+    /**
+     * @brief Flash ART accelerator settings (FLASH_ACR).
+     */
+    struct FlashAccelerator_t {
+        bool prefetch;      ///< Instruction prefetch (PRFTEN)
+        bool icache;        ///< Instruction cache (ICEN)
+        bool dcache;        ///< Data cache (DCEN)
+    };
+
+    static constexpr FlashAccelerator_t FlashAcceleratorOn{true, true, true};
+
+    ClockController(void) = delete;
+
+    /**
+     * @brief Returns the frequency in Hz of the given bus clock.
+     */
+    static uint32_t getBusFrequency(Bus_t bus) {
+        if(!isCacheValid()) {
+            refresh();
+        }
+        return (_cache.bus[static_cast<uint8_t>(bus)]);
+    }
+
+    /**
+     * @brief Returns the frequency in Hz of the given peripheral kernel clock (after the CCIPR mux).
+     * 
+     * A return value of 0 means that the kernel clock is disabled or its source is not running.
+     */
+    static uint32_t getKernelFrequency(KernelClock_t peripheral) {
+        if(!isCacheValid()) {
+            refresh();
+        }
+        return (_cache.kernel[static_cast<uint8_t>(peripheral)]);
+    }
+
+    /**
+     * @brief Marks the cached frequencies as stale. Must be called after every change of the clock tree.
+     * 
+     * Safe to call from any context, including an NMI that interrupts refresh().
+     */
+    static void invalidate(void) {
+        _generation.fetch_add(1U, std::memory_order_release);
+    }
+
+    /**
+     * @brief Re-reads the RCC configuration and updates the cache.
+     */
+    static void refresh(void);
+
+    /**
+     * @brief Registers a listener to be notified on clock changes.
+     * 
+     * @return false if MaxListeners are already registered
+     */
+    static bool registerListener(IClockListener& listener);
+
+    /**
+     * @brief Invalidates the frequency cache and notifies all registered listeners.
+     * 
+     * Called by the system clock code after every clock switch, including the HSE failure recovery.
+     */
+    static void notifyClockChange(void);
+
+    /**
+     * @brief Returns the number of flash wait states required for the given HCLK frequency.
+     * 
+     * @param hclk      AHB clock frequency in Hz
+     * @param boost     true if the regulator runs in range 1 boost mode (PWR_CR5.R1MODE = 0)
+     */
+    static constexpr uint32_t getFlashWaitStates(uint32_t hclk, bool boost = true) {
+        const uint32_t step = boost ? 34000000U : 30000000U;
+        return ((hclk == 0U) ? 0U : ((hclk - 1U) / step));
+    }
+
+    /**
+     * @brief Sets the flash wait states and the ART accelerator configuration.
+     * 
+     * Instruction and data cache are disabled and reset before the latency is changed, so that no
+     * line fetched with the previous latency survives. The caller has to apply the new latency before
+     * raising HCLK and after lowering it.
+     */
+    static void configureFlash(uint32_t waitStates, const FlashAccelerator_t& accel = FlashAcceleratorOn);
+
+private:
+    struct FrequencyCache_t {
+        uint32_t bus[static_cast<uint8_t>(Bus_t::NumOfBusses)];
+        uint32_t kernel[static_cast<uint8_t>(KernelClock_t::NumOfKernelClocks)];
     };
-}
\ No newline at end of file
+
+    static constexpr uint32_t InvalidGeneration = 0U;
+
+    static bool isCacheValid(void) {
+        return (_cacheGeneration.load(std::memory_order_acquire) == _generation.load(std::memory_order_acquire));
+    }
+
+    static inline FrequencyCache_t _cache{};
+    static inline std::atomic<uint32_t> _generation{InvalidGeneration + 1U};        ///< Advanced by invalidate()
+    static inline std::atomic<uint32_t> _cacheGeneration{InvalidGeneration};        ///< Generation _cache was read in
+
+    static constexpr uint8_t MaxListeners = 8U;
+
+    static inline IClockListener*   _listeners[MaxListeners]{};
+    static inline uint8_t           _numOfListeners{0U};
+};
+
+}   // namespace mcal
@@ -0,0 +1,178 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace  mcal {
+
+/// Enable register relative to RCC_AHB1ENR (in words); the sleep mode register is 8 words above.
+enum class ClockBus_t : uint8_t {
+    AHB1    = 0,
+    AHB2    = 1,
+    AHB3    = 2,
+    APB1_1  = 4,
+    APB1_2  = 5,
+    APB2    = 6,
+};
+
+/// Identifier of a peripheral clock: enable register in bits 7..5, bit position in bits 4..0
+constexpr uint16_t clockGateId(ClockBus_t bus, uint8_t bit) {
+    return (static_cast<uint16_t>((static_cast<uint16_t>(bus) << 5) | bit));
+}
+
+/**
+ * @brief Reference counted peripheral clock gating.
+ * 
+ * Drivers acquire the clock of their peripheral before use and release it afterwards. The enable bit
+ * in RCC_xxxENR is set on the first acquire and cleared when the last user releases the clock. The
+ * clock in sleep/stop mode (RCC_xxxSMENR) is counted separately and kept while at least one user
+ * requested it.
+ */
+class ClockGate {
+public:
+    using Bus_t = ClockBus_t;
+
+    static constexpr uint8_t NumOfBusses = 7U;
+    static constexpr uint8_t MaxUsers    = 0xFFU;   ///< Per peripheral, for the clock and for the sleep mode clock
+
+    enum class Peripheral_t : uint16_t {
+        Dma1        = clockGateId(ClockBus_t::AHB1, 0),
+        Dma2        = clockGateId(ClockBus_t::AHB1, 1),
+        DmaMux1     = clockGateId(ClockBus_t::AHB1, 2),
+        Cordic      = clockGateId(ClockBus_t::AHB1, 3),
+        Fmac        = clockGateId(ClockBus_t::AHB1, 4),
+        Crc         = clockGateId(ClockBus_t::AHB1, 12),
+        GpioA       = clockGateId(ClockBus_t::AHB2, 0),
+        GpioB       = clockGateId(ClockBus_t::AHB2, 1),
+        GpioC       = clockGateId(ClockBus_t::AHB2, 2),
+        GpioD       = clockGateId(ClockBus_t::AHB2, 3),
+        GpioE       = clockGateId(ClockBus_t::AHB2, 4),
+        GpioF       = clockGateId(ClockBus_t::AHB2, 5),
+        GpioG       = clockGateId(ClockBus_t::AHB2, 6),
+        Adc12       = clockGateId(ClockBus_t::AHB2, 13),
+        Adc345      = clockGateId(ClockBus_t::AHB2, 14),
+        Dac1        = clockGateId(ClockBus_t::AHB2, 16),
+        Dac2        = clockGateId(ClockBus_t::AHB2, 17),
+        Dac3        = clockGateId(ClockBus_t::AHB2, 18),
+        Dac4        = clockGateId(ClockBus_t::AHB2, 19),
+        Rng         = clockGateId(ClockBus_t::AHB2, 26),
+        Fmc         = clockGateId(ClockBus_t::AHB3, 0),
+        QuadSpi     = clockGateId(ClockBus_t::AHB3, 8),
+        Tim2        = clockGateId(ClockBus_t::APB1_1, 0),
+        Tim3        = clockGateId(ClockBus_t::APB1_1, 1),
+        Tim4        = clockGateId(ClockBus_t::APB1_1, 2),
+        Tim5        = clockGateId(ClockBus_t::APB1_1, 3),
+        Tim6        = clockGateId(ClockBus_t::APB1_1, 4),
+        Tim7        = clockGateId(ClockBus_t::APB1_1, 5),
+        Crs         = clockGateId(ClockBus_t::APB1_1, 8),
+        RtcApb      = clockGateId(ClockBus_t::APB1_1, 10),
+        Wwdg        = clockGateId(ClockBus_t::APB1_1, 11),
+        Spi2        = clockGateId(ClockBus_t::APB1_1, 14),
+        Spi3        = clockGateId(ClockBus_t::APB1_1, 15),
+        Usart2      = clockGateId(ClockBus_t::APB1_1, 17),
+        Usart3      = clockGateId(ClockBus_t::APB1_1, 18),
+        Uart4       = clockGateId(ClockBus_t::APB1_1, 19),
+        Uart5       = clockGateId(ClockBus_t::APB1_1, 20),
+        I2c1        = clockGateId(ClockBus_t::APB1_1, 21),
+        I2c2        = clockGateId(ClockBus_t::APB1_1, 22),
+        Usb         = clockGateId(ClockBus_t::APB1_1, 23),
+        FdCan       = clockGateId(ClockBus_t::APB1_1, 25),
+        Pwr         = clockGateId(ClockBus_t::APB1_1, 28),
+        I2c3        = clockGateId(ClockBus_t::APB1_1, 30),
+        LpTim1      = clockGateId(ClockBus_t::APB1_1, 31),
+        LpUart1     = clockGateId(ClockBus_t::APB1_2, 0),
+        I2c4        = clockGateId(ClockBus_t::APB1_2, 1),
+        Ucpd1       = clockGateId(ClockBus_t::APB1_2, 8),
+        SysCfg      = clockGateId(ClockBus_t::APB2, 0),
+        Tim1        = clockGateId(ClockBus_t::APB2, 11),
+        Spi1        = clockGateId(ClockBus_t::APB2, 12),
+        Tim8        = clockGateId(ClockBus_t::APB2, 13),
+        Usart1      = clockGateId(ClockBus_t::APB2, 14),
+        Spi4        = clockGateId(ClockBus_t::APB2, 15),
+        Tim15       = clockGateId(ClockBus_t::APB2, 16),
+        Tim16       = clockGateId(ClockBus_t::APB2, 17),
+        Tim17       = clockGateId(ClockBus_t::APB2, 18),
+        Tim20       = clockGateId(ClockBus_t::APB2, 20),
+        Sai1        = clockGateId(ClockBus_t::APB2, 21),
+        HrTim1      = clockGateId(ClockBus_t::APB2, 26),
+    };
+
+    enum class SleepMode_t : uint8_t {
+        Gated = 0,      ///< Clock may be stopped in sleep/stop mode
+        Running         ///< Clock has to keep running in sleep/stop mode (e.g. wake-up source)
+    };
+
+    /// Snapshot of the enable registers of all busses, indexed by Bus_t
+    struct Report_t {
+        uint32_t enabled[NumOfBusses];
+        uint32_t sleepEnabled[NumOfBusses];
+    };
+
+    ClockGate(void) = delete;
+
+    /**
+     * @brief Enables the clock of the peripheral if this is the first user.
+     * 
+     * @return false if the peripheral already has MaxUsers users, nothing is changed then
+     */
+    static bool acquire(Peripheral_t peripheral, SleepMode_t sleep = SleepMode_t::Gated);
+
+    /**
+     * @brief Disables the clock of the peripheral if this was the last user. sleep has to match the acquire() of
+     * this user: the sleep mode clock is disabled when the last SleepMode_t::Running user is gone.
+     */
+    static void release(Peripheral_t peripheral, SleepMode_t sleep = SleepMode_t::Gated);
+
+    /**
+     * @brief Returns the number of users of the peripheral clock.
+     */
+    static uint8_t getUsers(Peripheral_t peripheral) {
+        return (_users[static_cast<uint16_t>(peripheral)]);
+    }
+
+    /**
+     * @brief Returns the number of users that need the peripheral clock in sleep/stop mode.
+     */
+    static uint8_t getSleepUsers(Peripheral_t peripheral) {
+        return (_sleepUsers[static_cast<uint16_t>(peripheral)]);
+    }
+
+    /**
+     * @brief Gates all peripheral clocks in sleep/stop mode that are not requested as SleepMode_t::Running.
+     * 
+     * After reset all sleep mode enable bits are set. Call once during start-up to apply the mask.
+     */
+    static void applySleepMask(void);
+
+    /**
+     * @brief Reads back the currently enabled peripheral clocks.
+     */
+    static void getReport(Report_t& report);
+
+private:
+    static inline uint8_t   _users[NumOfBusses * 32U]{};
+    static inline uint8_t   _sleepUsers[NumOfBusses * 32U]{};   ///< Users that requested SleepMode_t::Running
+};
+
+}   // namespace mcal
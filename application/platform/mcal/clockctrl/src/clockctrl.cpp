@@ -22,6 +22,242 @@
 
 #include "clockctrl.h"		// Include own header first because it needs to compile in isolation
 
+#include "stm32g474xx_regs.h"
+#include "stm32g4xx.h"
+
+#if !defined  (HSE_VALUE)
+  #define HSE_VALUE     24000000U   ///< Value of the external oscillator in Hz
+#endif
+
+#if !defined  (HSI_VALUE)
+  #define HSI_VALUE     16000000U   ///< Value of the internal high speed oscillator in Hz
+#endif
+
+#if !defined  (LSE_VALUE)
+  #define LSE_VALUE     32768U      ///< Value of the external low speed oscillator in Hz
+#endif
+
+#if !defined  (LSI_VALUE)
+  #define LSI_VALUE     32000U      ///< Value of the internal low speed oscillator in Hz
+#endif
+
 namespace mcal {
 
+namespace {
+
+// RCC and FLASH through the register maps, the native build runs on the simulated register file
+using Rcc   = stm32g4::Rcc;
+using Flash = stm32g4::Flash;
+
+constexpr uint8_t ahbPrescalerShift[16] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U, 6U, 7U, 8U, 9U};
+constexpr uint8_t apbPrescalerShift[8]  = {0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U};
+
+uint32_t getPllInputFrequency(void) {
+    uint32_t pllm = ((Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos) + 1U;
+
+    switch(Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLSRC) {
+        case RCC_PLLCFGR_PLLSRC_HSI:
+            return (HSI_VALUE / pllm);
+        case RCC_PLLCFGR_PLLSRC_HSE:
+            return (HSE_VALUE / pllm);
+        default:
+            return (0U);
+    }
+}
+
+uint32_t getPllVcoFrequency(void) {
+    return (getPllInputFrequency() * ((Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLN) >> RCC_PLLCFGR_PLLN_Pos));
+}
+
+uint32_t getPllRFrequency(void) {
+    uint32_t pllr = (((Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLR) >> RCC_PLLCFGR_PLLR_Pos) + 1U) * 2U;
+    return (getPllVcoFrequency() / pllr);
+}
+
+uint32_t getPllPFrequency(void) {
+    if((Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLPEN) == 0U) {
+        return (0U);
+    }
+
+    uint32_t pllp = (Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLPDIV) >> RCC_PLLCFGR_PLLPDIV_Pos;
+    if(pllp == 0U) {
+        pllp = ((Rcc::Pllcfgr::read() & RCC_PLLCFGR_PLLP) != 0U) ? 17U : 7U;
+    }
+    return (getPllVcoFrequency() / pllp);
+}
+
+uint32_t getSysclkFrequency(void) {
+    switch(Rcc::Cfgr::read() & RCC_CFGR_SWS) {
+        case RCC_CFGR_SWS_HSI:
+            return (HSI_VALUE);
+        case RCC_CFGR_SWS_HSE:
+            return (HSE_VALUE);
+        case RCC_CFGR_SWS_PLL:
+            return (getPllRFrequency());
+        default:
+            return (0U);
+    }
+}
+
+/**
+ * @brief Oscillator frequencies for the kernel clock muxes, 0 while the oscillator is not ready.
+ */
+struct Oscillators_t {
+    uint32_t hsi;
+    uint32_t lse;
+    uint32_t lsi;
+};
+
+Oscillators_t getOscillators(void) {
+    return (Oscillators_t{
+        ((Rcc::Cr::read() & RCC_CR_HSIRDY) != 0U) ? HSI_VALUE : 0U,
+        ((Rcc::Bdcr::read() & RCC_BDCR_LSERDY) != 0U) ? LSE_VALUE : 0U,
+        ((Rcc::Csr::read() & RCC_CSR_LSIRDY) != 0U) ? LSI_VALUE : 0U,
+    });
+}
+
+/**
+ * @brief Decodes the common 2bit UART kernel clock mux (PCLK, SYSCLK, HSI16, LSE).
+ */
+uint32_t getUartKernelFrequency(uint32_t sel, uint32_t pclk, uint32_t sysclk, const Oscillators_t& osc) {
+    switch(sel) {
+        case 0U:    return (pclk);
+        case 1U:    return (sysclk);
+        case 2U:    return (osc.hsi);
+        default:    return (osc.lse);
+    }
+}
+
+/**
+ * @brief Decodes the common 2bit I2C kernel clock mux (PCLK1, SYSCLK, HSI16).
+ */
+uint32_t getI2cKernelFrequency(uint32_t sel, uint32_t pclk1, uint32_t sysclk, const Oscillators_t& osc) {
+    switch(sel) {
+        case 0U:    return (pclk1);
+        case 1U:    return (sysclk);
+        case 2U:    return (osc.hsi);
+        default:    return (0U);
+    }
+}
+
+/**
+ * @brief Decodes the common 2bit ADC kernel clock mux (none, PLLP, SYSCLK).
+ */
+uint32_t getAdcKernelFrequency(uint32_t sel, uint32_t pllp, uint32_t sysclk) {
+    switch(sel) {
+        case 1U:    return (pllp);
+        case 2U:    return (sysclk);
+        default:    return (0U);
+    }
+}
+
+inline uint32_t getMux(uint32_t reg, uint32_t pos) {
+    return ((reg >> pos) & 0x3U);
+}
+
+}   // anonymous namespace
+
+void ClockController::refresh(void) {
+    // an invalidate() from here on leaves the cache invalid, whatever this refresh publishes
+    const uint32_t generation = _generation.load(std::memory_order_acquire);
+    FrequencyCache_t cache{};
+
+    const uint32_t cfgr     = Rcc::Cfgr::read();
+    const uint32_t ccipr    = Rcc::Ccipr::read();
+    const uint32_t ccipr2   = Rcc::Ccipr2::read();
+
+    const uint32_t sysclk   = getSysclkFrequency();
+    const uint32_t hclk     = sysclk >> ahbPrescalerShift[(cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+    const uint8_t  ppre1    = apbPrescalerShift[(cfgr & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    const uint8_t  ppre2    = apbPrescalerShift[(cfgr & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos];
+    const uint32_t pclk1    = hclk >> ppre1;
+    const uint32_t pclk2    = hclk >> ppre2;
+    const uint32_t pllp     = getPllPFrequency();
+    const Oscillators_t osc = getOscillators();
+
+    cache.bus[static_cast<uint8_t>(Bus_t::SYSCLK)]      = sysclk;
+    cache.bus[static_cast<uint8_t>(Bus_t::HCLK)]        = hclk;
+    cache.bus[static_cast<uint8_t>(Bus_t::PCLK1)]       = pclk1;
+    cache.bus[static_cast<uint8_t>(Bus_t::PCLK2)]       = pclk2;
+    cache.bus[static_cast<uint8_t>(Bus_t::TIMPCLK1)]    = (ppre1 == 0U) ? pclk1 : (pclk1 * 2U);
+    cache.bus[static_cast<uint8_t>(Bus_t::TIMPCLK2)]    = (ppre2 == 0U) ? pclk2 : (pclk2 * 2U);
+
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Usart1)]   = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_USART1SEL_Pos), pclk2, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Usart2)]   = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_USART2SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Usart3)]   = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_USART3SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Uart4)]    = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_UART4SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Uart5)]    = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_UART5SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::LpUart1)]  = getUartKernelFrequency(getMux(ccipr, RCC_CCIPR_LPUART1SEL_Pos), pclk1, sysclk, osc);
+
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::I2c1)]     = getI2cKernelFrequency(getMux(ccipr, RCC_CCIPR_I2C1SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::I2c2)]     = getI2cKernelFrequency(getMux(ccipr, RCC_CCIPR_I2C2SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::I2c3)]     = getI2cKernelFrequency(getMux(ccipr, RCC_CCIPR_I2C3SEL_Pos), pclk1, sysclk, osc);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::I2c4)]     = getI2cKernelFrequency(getMux(ccipr2, RCC_CCIPR2_I2C4SEL_Pos), pclk1, sysclk, osc);
+
+    switch(getMux(ccipr, RCC_CCIPR_LPTIM1SEL_Pos)) {
+        case 0U:    cache.kernel[static_cast<uint8_t>(KernelClock_t::LpTim1)] = pclk1;        break;
+        case 1U:    cache.kernel[static_cast<uint8_t>(KernelClock_t::LpTim1)] = osc.lsi;      break;
+        case 2U:    cache.kernel[static_cast<uint8_t>(KernelClock_t::LpTim1)] = osc.hsi;      break;
+        default:    cache.kernel[static_cast<uint8_t>(KernelClock_t::LpTim1)] = osc.lse;      break;
+    }
+
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Adc12)]    = getAdcKernelFrequency(getMux(ccipr, RCC_CCIPR_ADC12SEL_Pos), pllp, sysclk);
+    cache.kernel[static_cast<uint8_t>(KernelClock_t::Adc345)]   = getAdcKernelFrequency(getMux(ccipr, RCC_CCIPR_ADC345SEL_Pos), pllp, sysclk);
+
+    // readers interrupting the copy must not see a half written cache as valid
+    _cacheGeneration.store(InvalidGeneration, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    _cache = cache;
+    _cacheGeneration.store(generation, std::memory_order_release);
+}
+
+bool ClockController::registerListener(IClockListener& listener) {
+    if(_numOfListeners >= MaxListeners) {
+        return (false);
+    }
+    _listeners[_numOfListeners] = &listener;
+    _numOfListeners++;
+    return (true);
+}
+
+void ClockController::notifyClockChange(void) {
+    invalidate();
+    for(uint8_t i = 0U; i < _numOfListeners; i++) {
+        _listeners[i]->onClockChange();
+    }
+}
+
+void ClockController::configureFlash(uint32_t waitStates, const FlashAccelerator_t& accel) {
+    device_register& flashAcr = Flash::Acr::get();
+    uint32_t acr = flashAcr & ~(FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+
+    // caches can only be reset while they are disabled
+    flashAcr = acr;
+    flashAcr = acr | FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+    flashAcr = acr;
+
+    acr = (acr & ~FLASH_ACR_LATENCY) | ((waitStates << FLASH_ACR_LATENCY_Pos) & FLASH_ACR_LATENCY);
+    flashAcr = acr;
+    while((flashAcr & FLASH_ACR_LATENCY) != (acr & FLASH_ACR_LATENCY)) {}    // new latency must be effective before caches are re-enabled
+
+    if(accel.prefetch) {
+        acr |= FLASH_ACR_PRFTEN;
+    }
+    if(accel.icache) {
+        acr |= FLASH_ACR_ICEN;
+    }
+    if(accel.dcache) {
+        acr |= FLASH_ACR_DCEN;
+    }
+    flashAcr = acr;
+}
+
+}   // namespace mcal
+
+/**
+ * @brief Overrides the weak hook of the system clock code so that a clock switch done there (deferred
+ * PLL switch of FAST_BOOT, HSE failure recovery) invalidates the cache and re-times the peripherals.
+ */
+extern "C" void SystemCoreClockChanged(void) {
+    mcal::ClockController::notifyClockChange();
 }
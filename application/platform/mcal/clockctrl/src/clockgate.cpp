@@ -0,0 +1,145 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "clockgate.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#include "cpu.h"
+#include "device_register.h"
+#include "stm32g474xx_regs.h"
+#include "stm32g4xx.h"
+
+namespace mcal {
+
+namespace {
+
+using Rcc = stm32g4::Rcc;
+using CriticalSection = cpu::CriticalSection;
+
+constexpr uint32_t SleepRegisterOffset = 8U;    ///< RCC_AHB1SMENR - RCC_AHB1ENR in words
+
+inline device_register& getEnableRegister(uint8_t bus) {
+    return (getPeripheral<device_register>(Rcc::Ahb1enr::Address + 4U*bus));
+}
+
+inline device_register& getSleepRegister(uint8_t bus) {
+    return (getPeripheral<device_register>(Rcc::Ahb1enr::Address + 4U*(SleepRegisterOffset + bus)));
+}
+
+}   // anonymous namespace
+
+static_assert(Rcc::Ahb1smenr::Address == (Rcc::Ahb1enr::Address + 4U*SleepRegisterOffset), "unexpected RCC register layout");
+static_assert(offsetof(RCC_TypeDef, AHB1SMENR) == (offsetof(RCC_TypeDef, AHB1ENR) + 4U*SleepRegisterOffset), "unexpected RCC register layout");
+static_assert(offsetof(RCC_TypeDef, APB2ENR) == (offsetof(RCC_TypeDef, AHB1ENR) + 4U*static_cast<uint8_t>(ClockGate::Bus_t::APB2)), "unexpected RCC register layout");
+
+bool ClockGate::acquire(Peripheral_t peripheral, SleepMode_t sleep) {
+    const uint16_t index = static_cast<uint16_t>(peripheral);
+    const uint8_t  bus   = static_cast<uint8_t>(index >> 5);
+    const uint32_t mask  = 1UL << (index & 0x1FU);
+    const bool     running = (sleep == SleepMode_t::Running);
+
+    CriticalSection lock;
+
+    // a wrapped counter would gate the clock of the remaining users
+    if((_users[index] == MaxUsers) || (running && (_sleepUsers[index] == MaxUsers))) {
+        return (false);
+    }
+
+    if(running) {
+        if(_sleepUsers[index] == 0U) {
+            getSleepRegister(bus) |= mask;
+        }
+        _sleepUsers[index]++;
+    }
+
+    if(_users[index] == 0U) {
+        getEnableRegister(bus) |= mask;
+        (void)static_cast<uint32_t>(getEnableRegister(bus));      // read back: delay until the clock is active
+    }
+    _users[index]++;
+    return (true);
+}
+
+void ClockGate::release(Peripheral_t peripheral, SleepMode_t sleep) {
+    const uint16_t index = static_cast<uint16_t>(peripheral);
+    const uint8_t  bus   = static_cast<uint8_t>(index >> 5);
+    const uint32_t mask  = 1UL << (index & 0x1FU);
+
+    CriticalSection lock;
+
+    if(_users[index] == 0U) {
+        return;
+    }
+
+    if((sleep == SleepMode_t::Running) && (_sleepUsers[index] > 0U)) {
+        _sleepUsers[index]--;
+        if(_sleepUsers[index] == 0U) {
+            getSleepRegister(bus) &= ~mask;
+        }
+    }
+
+    _users[index]--;
+    if(_users[index] == 0U) {
+        getEnableRegister(bus) &= ~mask;
+        _sleepUsers[index] = 0U;
+        getSleepRegister(bus) &= ~mask;
+    }
+}
+
+void ClockGate::applySleepMask(void) {
+    constexpr Bus_t busses[] = {Bus_t::AHB1, Bus_t::AHB2, Bus_t::AHB3, Bus_t::APB1_1, Bus_t::APB1_2, Bus_t::APB2};
+
+    CriticalSection lock;
+
+    for(Bus_t b : busses) {
+        const uint8_t bus = static_cast<uint8_t>(b);
+        uint32_t keep = 0U;
+        for(uint8_t bit = 0U; bit < 32U; bit++) {
+            if(_sleepUsers[(bus * 32U) + bit] != 0U) {
+                keep |= (1UL << bit);
+            }
+        }
+
+        // memories stay accessible
+        if(b == Bus_t::AHB1) {
+            keep |= RCC_AHB1SMENR_FLASHSMEN | RCC_AHB1SMENR_SRAM1SMEN;
+        } else if(b == Bus_t::AHB2) {
+            keep |= RCC_AHB2SMENR_CCMSRAMSMEN | RCC_AHB2SMENR_SRAM2SMEN;
+        }
+        getSleepRegister(bus) &= keep;
+    }
+}
+
+void ClockGate::getReport(Report_t& report) {
+    for(uint8_t bus = 0U; bus < NumOfBusses; bus++) {
+        if(bus == 3U) {     // reserved register
+            report.enabled[bus]      = 0U;
+            report.sleepEnabled[bus] = 0U;
+            continue;
+        }
+        report.enabled[bus]      = getEnableRegister(bus);
+        report.sleepEnabled[bus] = getSleepRegister(bus);
+    }
+}
+
+}   // namespace mcal
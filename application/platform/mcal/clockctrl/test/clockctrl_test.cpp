@@ -0,0 +1,288 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "clockctrl.h"
+#include "registerfile.h"
+#include "stm32g474xx_regs.h"
+#include "unittest.h"
+
+using mcal::ClockController;
+using mcal::sim::RegisterFile;
+using Rcc = mcal::stm32g4::Rcc;
+using Flash = mcal::stm32g4::Flash;
+
+namespace {
+
+using Bus_t = ClockController::Bus_t;
+using KernelClock_t = ClockController::KernelClock_t;
+
+/// PLL of the application: HSE 24 MHz / 6 * 85 / 2 = 170 MHz, P output / 10 = 34 MHz
+constexpr uint32_t Pll170MHz = Rcc::Pllcfgr::Pllsrc::value<3U>().bits | Rcc::Pllcfgr::Pllm::value<5U>().bits |
+                               Rcc::Pllcfgr::Plln::value<85U>().bits | Rcc::Pllcfgr::Pllren::set().bits |
+                               Rcc::Pllcfgr::Pllpen::set().bits | Rcc::Pllcfgr::Pllpdiv::value<10U>().bits;
+
+constexpr uint32_t SysclkPll = Rcc::Cfgr::Sw::value<3U>().bits | Rcc::Cfgr::Sws::value<3U>().bits;
+
+/// HSI16, LSE and LSI running
+void startOscillators(void) {
+    RegisterFile::poke(Rcc::Cr::Address, Rcc::Cr::Hsion::set().bits | Rcc::Cr::Hsirdy::set().bits);
+    RegisterFile::poke(Rcc::Bdcr::Address, Rcc::Bdcr::Lseon::set().bits | Rcc::Bdcr::Lserdy::set().bits);
+    RegisterFile::poke(Rcc::Csr::Address, Rcc::Csr::Lsion::set().bits | Rcc::Csr::Lsirdy::set().bits);
+}
+
+class Listener : public mcal::IClockListener {
+public:
+    void onClockChange(void) override {
+        calls++;
+    }
+
+    uint32_t calls = 0U;
+};
+
+Listener listener;
+
+void setUp(uint32_t cfgr, uint32_t ccipr = 0U) {
+    RegisterFile::reset();
+    RegisterFile::poke(Rcc::Pllcfgr::Address, Pll170MHz);
+    RegisterFile::poke(Rcc::Cfgr::Address, cfgr);
+    RegisterFile::poke(Rcc::Ccipr::Address, ccipr);
+    ClockController::invalidate();
+}
+
+void testBusFrequencies(void) {
+    setUp(SysclkPll | Rcc::Cfgr::Ppre1::value<4U>().bits | Rcc::Cfgr::Ppre2::value<5U>().bits);    // APB1 / 2, APB2 / 4
+
+    TEST_EQUAL(170000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+    TEST_EQUAL(170000000U, ClockController::getBusFrequency(Bus_t::HCLK));
+    TEST_EQUAL(85000000U, ClockController::getBusFrequency(Bus_t::PCLK1));
+    TEST_EQUAL(42500000U, ClockController::getBusFrequency(Bus_t::PCLK2));
+    TEST_EQUAL(170000000U, ClockController::getBusFrequency(Bus_t::TIMPCLK1));     // x2 behind a prescaler
+    TEST_EQUAL(85000000U, ClockController::getBusFrequency(Bus_t::TIMPCLK2));
+}
+
+void testHsiAndAhbPrescaler(void) {
+    setUp(Rcc::Cfgr::Sws::value<1U>().bits | Rcc::Cfgr::Hpre::value<8U>().bits);    // HSI16, AHB / 2
+
+    TEST_EQUAL(16000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+    TEST_EQUAL(8000000U, ClockController::getBusFrequency(Bus_t::HCLK));
+    TEST_EQUAL(8000000U, ClockController::getBusFrequency(Bus_t::TIMPCLK1));       // no APB prescaler, no doubling
+}
+
+void testKernelClockMux(void) {
+    setUp(SysclkPll | Rcc::Cfgr::Ppre1::value<4U>().bits,
+          Rcc::Ccipr::Usart1sel::value<0U>().bits | Rcc::Ccipr::Usart2sel::value<1U>().bits |
+          Rcc::Ccipr::Usart3sel::value<2U>().bits | Rcc::Ccipr::Lpuart1sel::value<3U>().bits |
+          Rcc::Ccipr::I2c1sel::value<2U>().bits | Rcc::Ccipr::I2c2sel::value<3U>().bits |
+          Rcc::Ccipr::Lptim1sel::value<1U>().bits | Rcc::Ccipr::Adc12sel::value<1U>().bits);
+    startOscillators();
+
+    TEST_EQUAL(170000000U, ClockController::getKernelFrequency(KernelClock_t::Usart1));   // PCLK2
+    TEST_EQUAL(170000000U, ClockController::getKernelFrequency(KernelClock_t::Usart2));   // SYSCLK
+    TEST_EQUAL(16000000U, ClockController::getKernelFrequency(KernelClock_t::Usart3));    // HSI16
+    TEST_EQUAL(32768U, ClockController::getKernelFrequency(KernelClock_t::LpUart1));      // LSE
+    TEST_EQUAL(85000000U, ClockController::getKernelFrequency(KernelClock_t::Uart4));     // PCLK1
+    TEST_EQUAL(16000000U, ClockController::getKernelFrequency(KernelClock_t::I2c1));
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::I2c2));             // reserved
+    TEST_EQUAL(32000U, ClockController::getKernelFrequency(KernelClock_t::LpTim1));       // LSI
+    TEST_EQUAL(34000000U, ClockController::getKernelFrequency(KernelClock_t::Adc12));     // PLLP
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::Adc345));           // no clock
+}
+
+void testKernelClockOscillatorNotReady(void) {
+    setUp(SysclkPll,
+          Rcc::Ccipr::Usart3sel::value<2U>().bits | Rcc::Ccipr::Lpuart1sel::value<3U>().bits |
+          Rcc::Ccipr::I2c1sel::value<2U>().bits | Rcc::Ccipr::Lptim1sel::value<1U>().bits);
+
+    // HSI16 stopped (HSION clear), LSE and LSI not started
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::Usart3));
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::LpUart1));
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::I2c1));
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::LpTim1));
+
+    // started but not ready yet
+    RegisterFile::poke(Rcc::Cr::Address, Rcc::Cr::Hsion::set().bits);
+    RegisterFile::poke(Rcc::Bdcr::Address, Rcc::Bdcr::Lseon::set().bits);
+    ClockController::invalidate();
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::Usart3));
+    TEST_EQUAL(0U, ClockController::getKernelFrequency(KernelClock_t::LpUart1));
+
+    startOscillators();
+    ClockController::invalidate();
+    TEST_EQUAL(16000000U, ClockController::getKernelFrequency(KernelClock_t::Usart3));
+    TEST_EQUAL(32768U, ClockController::getKernelFrequency(KernelClock_t::LpUart1));
+    TEST_EQUAL(16000000U, ClockController::getKernelFrequency(KernelClock_t::I2c1));
+    TEST_EQUAL(32000U, ClockController::getKernelFrequency(KernelClock_t::LpTim1));
+}
+
+void testInvalidateDuringRefresh(void) {
+    setUp(SysclkPll);
+
+    // CSS NMI in the middle of refresh(): HSE is lost, SYSCLK falls back to HSI16 and the NMI invalidates
+    bool nmi = true;
+    RegisterFile::setReadHook(Rcc::Csr::Address, [&nmi](uintptr_t, uint32_t stored) {
+        if(nmi) {
+            nmi = false;
+            RegisterFile::poke(Rcc::Cfgr::Address, Rcc::Cfgr::Sws::value<1U>().bits);
+            ClockController::invalidate();
+        }
+        return (stored);
+    });
+
+    ClockController::refresh();     // read the PLL configuration before the NMI
+    RegisterFile::clearTrace();
+    TEST_EQUAL(16000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+    TEST_CHECK(RegisterFile::getTrace().size() > 0U);       // stale result was not published
+    RegisterFile::clearTrace();
+    TEST_EQUAL(16000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+    TEST_EQUAL(0U, RegisterFile::getTrace().size());
+}
+
+void testQueriesUseTheCache(void) {
+    setUp(SysclkPll);
+
+    ClockController::refresh();
+    RegisterFile::clearTrace();
+    for(uint32_t i = 0U; i < 100U; i++) {
+        (void)ClockController::getBusFrequency(Bus_t::PCLK1);
+        (void)ClockController::getKernelFrequency(KernelClock_t::Usart2);
+    }
+    TEST_EQUAL(0U, RegisterFile::getTrace().size());
+
+    // a stale cache is re-read once on the next query
+    RegisterFile::poke(Rcc::Cfgr::Address, SysclkPll | Rcc::Cfgr::Ppre1::value<4U>().bits);
+    ClockController::invalidate();
+    TEST_EQUAL(85000000U, ClockController::getBusFrequency(Bus_t::PCLK1));
+    const size_t reads = RegisterFile::getTrace().size();
+    TEST_CHECK(reads > 0U);
+    TEST_EQUAL(85000000U, ClockController::getBusFrequency(Bus_t::PCLK1));
+    TEST_EQUAL(reads, RegisterFile::getTrace().size());
+}
+
+void testClockChangeNotifiesListeners(void) {
+    setUp(SysclkPll);
+    TEST_CHECK(ClockController::registerListener(listener));
+    TEST_EQUAL(170000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+
+    RegisterFile::poke(Rcc::Cfgr::Address, Rcc::Cfgr::Sws::value<1U>().bits);    // e.g. HSE failure, back on HSI16
+    ClockController::notifyClockChange();
+
+    TEST_EQUAL(1U, listener.calls);
+    TEST_EQUAL(16000000U, ClockController::getBusFrequency(Bus_t::SYSCLK));
+}
+
+/**
+ * Flash interface model: a new LATENCY becomes visible after two reads, and it counts the writes that reset a
+ * cache while it is enabled or change the latency while a cache is enabled.
+ */
+struct FlashModel_t {
+    uint32_t pendingReads;
+    uint32_t latency;
+    uint32_t violations;
+};
+
+FlashModel_t flashModel;
+
+void installFlashModel(uint32_t acr) {
+    flashModel = FlashModel_t{0U, acr & Flash::Acr::Latency::Mask, 0U};
+    RegisterFile::poke(Flash::Acr::Address, acr);
+
+    RegisterFile::setWriteHook(Flash::Acr::Address, [](uintptr_t, uint32_t written, uint32_t stored) {
+        constexpr uint32_t caches = Flash::Acr::Icen::Mask | Flash::Acr::Dcen::Mask;
+        constexpr uint32_t resets = Flash::Acr::Icrst::Mask | Flash::Acr::Dcrst::Mask;
+        const uint32_t latency = written & Flash::Acr::Latency::Mask;
+        if(((written & resets) != 0U) && (((stored | written) & caches) != 0U)) {
+            flashModel.violations++;
+        }
+        if((latency != (stored & Flash::Acr::Latency::Mask)) && (((stored | written) & caches) != 0U)) {
+            flashModel.violations++;
+        }
+        if(latency != flashModel.latency) {
+            flashModel.pendingReads = 2U;
+        }
+        return (written);
+    });
+
+    RegisterFile::setReadHook(Flash::Acr::Address, [](uintptr_t, uint32_t stored) {
+        if(flashModel.pendingReads > 0U) {
+            flashModel.pendingReads--;
+            return ((stored & ~Flash::Acr::Latency::Mask) | flashModel.latency);
+        }
+        flashModel.latency = stored & Flash::Acr::Latency::Mask;
+        return (stored);
+    });
+}
+
+void testFlashWaitStates(void) {
+    // RM0440 table 9, range 1 boost mode: 34 MHz per wait state
+    TEST_EQUAL(0U, ClockController::getFlashWaitStates(16000000U));
+    TEST_EQUAL(0U, ClockController::getFlashWaitStates(34000000U));
+    TEST_EQUAL(1U, ClockController::getFlashWaitStates(34000001U));
+    TEST_EQUAL(2U, ClockController::getFlashWaitStates(102000000U));
+    TEST_EQUAL(3U, ClockController::getFlashWaitStates(136000000U));
+    TEST_EQUAL(4U, ClockController::getFlashWaitStates(170000000U));
+
+    // range 1 normal mode: 30 MHz per wait state
+    TEST_EQUAL(0U, ClockController::getFlashWaitStates(30000000U, false));
+    TEST_EQUAL(1U, ClockController::getFlashWaitStates(60000000U, false));
+    TEST_EQUAL(4U, ClockController::getFlashWaitStates(150000000U, false));
+    TEST_EQUAL(0U, ClockController::getFlashWaitStates(0U));
+}
+
+void testConfigureFlash(void) {
+    RegisterFile::reset();
+    installFlashModel(Flash::Acr::Reset);       // caches on, 0 wait states
+
+    ClockController::configureFlash(ClockController::getFlashWaitStates(170000000U));
+
+    const uint32_t acr = RegisterFile::peek(Flash::Acr::Address);
+    TEST_EQUAL(0U, flashModel.violations);
+    TEST_EQUAL(4U | Flash::Acr::Prften::Mask | Flash::Acr::Icen::Mask | Flash::Acr::Dcen::Mask, acr);
+    TEST_EQUAL(4U, flashModel.latency);         // the caches were enabled after the new latency was effective
+    TEST_EQUAL(5U, RegisterFile::getNumOfWrites(Flash::Acr::Address));
+}
+
+void testConfigureFlashWithoutAccelerator(void) {
+    RegisterFile::reset();
+    installFlashModel(4U | Flash::Acr::Prften::Mask | Flash::Acr::Icen::Mask | Flash::Acr::Dcen::Mask);
+
+    ClockController::configureFlash(1U, ClockController::FlashAccelerator_t{false, false, false});
+
+    TEST_EQUAL(0U, flashModel.violations);
+    TEST_EQUAL(1U, RegisterFile::peek(Flash::Acr::Address));
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"bus frequencies from the PLL", testBusFrequencies},
+        {"HSI16 and AHB prescaler", testHsiAndAhbPrescaler},
+        {"kernel clock mux", testKernelClockMux},
+        {"kernel clock of a stopped oscillator", testKernelClockOscillatorNotReady},
+        {"invalidate() during refresh()", testInvalidateDuringRefresh},
+        {"queries use the cache", testQueriesUseTheCache},
+        {"clock change notifies the listeners", testClockChangeNotifiesListeners},
+        {"flash wait states", testFlashWaitStates},
+        {"configureFlash() sequence", testConfigureFlash},
+        {"configureFlash() without accelerator", testConfigureFlashWithoutAccelerator},
+    }));
+}
@@ -0,0 +1,164 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "clockgate.h"
+#include "registerfile.h"
+#include "stm32g474xx_regs.h"
+#include "unittest.h"
+
+using mcal::ClockGate;
+using mcal::sim::RegisterFile;
+using Rcc = mcal::stm32g4::Rcc;
+
+namespace {
+
+using Peripheral_t = ClockGate::Peripheral_t;
+using SleepMode_t = ClockGate::SleepMode_t;
+
+constexpr uint32_t GpioA = Rcc::Ahb2enr::Gpioaen::Mask;
+constexpr uint32_t GpioB = Rcc::Ahb2enr::Gpioben::Mask;
+constexpr uint32_t Usart2 = Rcc::Apb1enr1::Usart2en::Mask;
+
+void setUp(void) {
+    RegisterFile::reset();
+}
+
+void testFirstAcquireEnablesLastReleaseDisables(void) {
+    setUp();
+
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioA));
+    TEST_EQUAL(GpioA, RegisterFile::peek(Rcc::Ahb2enr::Address));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioA));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioB));
+    TEST_EQUAL(GpioA | GpioB, RegisterFile::peek(Rcc::Ahb2enr::Address));
+    TEST_EQUAL(2U, ClockGate::getUsers(Peripheral_t::GpioA));
+    TEST_EQUAL(2U, RegisterFile::getNumOfWrites(Rcc::Ahb2enr::Address));    // once per peripheral
+
+    ClockGate::release(Peripheral_t::GpioA);
+    TEST_EQUAL(GpioA | GpioB, RegisterFile::peek(Rcc::Ahb2enr::Address));   // one user left
+    ClockGate::release(Peripheral_t::GpioA);
+    TEST_EQUAL(GpioB, RegisterFile::peek(Rcc::Ahb2enr::Address));
+    TEST_EQUAL(0U, ClockGate::getUsers(Peripheral_t::GpioA));
+
+    ClockGate::release(Peripheral_t::GpioA);        // unbalanced release is ignored
+    TEST_EQUAL(0U, ClockGate::getUsers(Peripheral_t::GpioA));
+    TEST_EQUAL(GpioB, RegisterFile::peek(Rcc::Ahb2enr::Address));
+
+    ClockGate::release(Peripheral_t::GpioB);
+    TEST_EQUAL(0U, RegisterFile::peek(Rcc::Ahb2enr::Address));
+}
+
+void testEnableIsReadBack(void) {
+    setUp();
+
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::Usart2));
+    const auto& trace = RegisterFile::getTrace();
+    TEST_EQUAL(3U, trace.size());                   // read-modify-write, read back
+    TEST_EQUAL(RegisterFile::Access_t::Write, trace[1].access);
+    TEST_EQUAL(Rcc::Apb1enr1::Address, trace[2].address);
+    TEST_EQUAL(RegisterFile::Access_t::Read, trace[2].access);
+    TEST_EQUAL(Usart2, trace[2].value);
+    ClockGate::release(Peripheral_t::Usart2);
+}
+
+void testSleepUsersPerPeripheral(void) {
+    setUp();
+
+    // GPIOA and GPIOB share AHB2SMENR, their sleep users are counted separately
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioA, SleepMode_t::Running));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioB, SleepMode_t::Running));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioA, SleepMode_t::Running));
+    TEST_EQUAL(GpioA | GpioB, RegisterFile::peek(Rcc::Ahb2smenr::Address));
+    TEST_EQUAL(2U, ClockGate::getSleepUsers(Peripheral_t::GpioA));
+    TEST_EQUAL(1U, ClockGate::getSleepUsers(Peripheral_t::GpioB));
+
+    ClockGate::release(Peripheral_t::GpioB, SleepMode_t::Running);
+    TEST_EQUAL(GpioA, RegisterFile::peek(Rcc::Ahb2smenr::Address));
+    ClockGate::release(Peripheral_t::GpioA, SleepMode_t::Running);
+    TEST_EQUAL(GpioA, RegisterFile::peek(Rcc::Ahb2smenr::Address));     // second GPIOA user still running
+    ClockGate::release(Peripheral_t::GpioA, SleepMode_t::Running);
+    TEST_EQUAL(0U, RegisterFile::peek(Rcc::Ahb2smenr::Address));
+    TEST_EQUAL(0U, RegisterFile::peek(Rcc::Ahb2enr::Address));
+}
+
+void testGatedUserKeepsSleepClockOff(void) {
+    setUp();
+
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::Usart2, SleepMode_t::Running));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::Usart2));
+    ClockGate::release(Peripheral_t::Usart2, SleepMode_t::Running);
+
+    TEST_EQUAL(Usart2, RegisterFile::peek(Rcc::Apb1enr1::Address));
+    TEST_EQUAL(0U, RegisterFile::peek(Rcc::Apb1smenr1::Address));
+    TEST_EQUAL(0U, ClockGate::getSleepUsers(Peripheral_t::Usart2));
+    ClockGate::release(Peripheral_t::Usart2);
+}
+
+void testOverflowIsRejected(void) {
+    setUp();
+
+    for(uint32_t i = 0U; i < ClockGate::MaxUsers; i++) {
+        TEST_CHECK(ClockGate::acquire(Peripheral_t::Crc));
+    }
+    TEST_CHECK(!ClockGate::acquire(Peripheral_t::Crc));
+    TEST_EQUAL(ClockGate::MaxUsers, ClockGate::getUsers(Peripheral_t::Crc));
+
+    for(uint32_t i = 0U; i < (ClockGate::MaxUsers - 1U); i++) {
+        ClockGate::release(Peripheral_t::Crc);
+    }
+    TEST_EQUAL(Rcc::Ahb1enr::Crcen::Mask, RegisterFile::peek(Rcc::Ahb1enr::Address));  // a wrap would have gated it
+    ClockGate::release(Peripheral_t::Crc);
+    TEST_EQUAL(0U, RegisterFile::peek(Rcc::Ahb1enr::Address));
+}
+
+void testSleepMask(void) {
+    setUp();
+    constexpr uint32_t ahb1Memories = Rcc::Ahb1smenr::Flashsmen::Mask | Rcc::Ahb1smenr::Sram1smen::Mask;
+    constexpr uint32_t ahb2Memories = Rcc::Ahb2smenr::Ccmsramsmen::Mask | Rcc::Ahb2smenr::Sram2smen::Mask;
+    RegisterFile::poke(Rcc::Ahb1smenr::Address, 0xFFFFFFFFU);      // all set after reset
+    RegisterFile::poke(Rcc::Ahb2smenr::Address, 0xFFFFFFFFU);
+    RegisterFile::poke(Rcc::Apb1smenr1::Address, 0xFFFFFFFFU);
+
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::Usart2, SleepMode_t::Running));
+    TEST_CHECK(ClockGate::acquire(Peripheral_t::GpioA));
+    ClockGate::applySleepMask();
+
+    TEST_EQUAL(ahb1Memories, RegisterFile::peek(Rcc::Ahb1smenr::Address));
+    TEST_EQUAL(ahb2Memories, RegisterFile::peek(Rcc::Ahb2smenr::Address));
+    TEST_EQUAL(Usart2, RegisterFile::peek(Rcc::Apb1smenr1::Address));
+
+    ClockGate::release(Peripheral_t::Usart2, SleepMode_t::Running);
+    ClockGate::release(Peripheral_t::GpioA);
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"first acquire enables, last release disables", testFirstAcquireEnablesLastReleaseDisables},
+        {"enable is read back", testEnableIsReadBack},
+        {"sleep users per peripheral", testSleepUsersPerPeripheral},
+        {"gated user keeps the sleep clock off", testGatedUserKeepsSleepClockOff},
+        {"overflow is rejected", testOverflowIsRejected},
+        {"sleep mask", testSleepMask},
+    }));
+}
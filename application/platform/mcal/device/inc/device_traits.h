@@ -0,0 +1,149 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace mcal {
+
+enum class Family_t : uint8_t {
+    Stm32F4,
+    Stm32G4
+};
+
+enum class Port_t : uint8_t {A = 0, B, C, D, E, F, G, H, I};
+
+/// How DMA requests of the peripherals reach a DMA channel
+enum class DmaRouting_t : uint8_t {
+    ChannelSelect,      ///< fixed request to stream mapping, the request is picked with the CHSEL field (F4)
+    DmaMux              ///< any request on any channel via the DMAMUX (G4)
+};
+
+/// GPIO registers with a port specific reset value, all other registers reset to 0
+struct GpioReset_t {
+    uint32_t moder;
+    uint32_t ospeedr;
+    uint32_t pupdr;
+};
+
+/**
+ * @brief Compile time description of a device family: memory map, available resources and register layout
+ * differences. Specialized per family, the drivers select their implementation on these constants, so there is
+ * nothing left to check at runtime. Checked against the CMSIS device header in device_traits.cpp.
+ */
+template<Family_t F>
+struct DeviceTraits;
+
+/// STM32G474xx: GPIO on AHB2, BRR register, DMAMUX
+template<>
+struct DeviceTraits<Family_t::Stm32G4> {
+    static constexpr Family_t Family            = Family_t::Stm32G4;
+
+    static constexpr uintptr_t GpioBase         = 0x48000000U;
+    static constexpr uintptr_t GpioStride       = 0x400U;
+    static constexpr uint32_t NumOfPorts        = 7U;           ///< A to G
+    static constexpr bool HasBrr                = true;         ///< BRR at offset 0x28 resets ODR bits
+
+    static constexpr uint16_t getPinMask(Port_t port) {
+        return ((port == Port_t::G) ? 0x07FFU : 0xFFFFU);
+    }
+
+    static constexpr GpioReset_t getGpioReset(Port_t port) {
+        return ((port == Port_t::A) ? GpioReset_t{0xABFFFFFFU, 0x0C000000U, 0x64000000U} :
+                (port == Port_t::B) ? GpioReset_t{0xFFFFFEBFU, 0x00000000U, 0x00000100U} :
+                                      GpioReset_t{0xFFFFFFFFU, 0x00000000U, 0x00000000U});
+    }
+
+    static constexpr uintptr_t Dma1Base         = 0x40020000U;
+    static constexpr uintptr_t Dma2Base         = 0x40020400U;
+    static constexpr uintptr_t DmaMuxBase       = 0x40020800U;
+    static constexpr uint32_t NumOfDmaChannels  = 8U;           ///< per controller
+    static constexpr DmaRouting_t DmaRouting    = DmaRouting_t::DmaMux;
+    static constexpr bool Dma1MemToMem          = true;         ///< DMA1 can copy memory to memory
+};
+
+/// STM32F407xx: GPIO on AHB1 without BRR, DMA streams with fixed request mapping
+template<>
+struct DeviceTraits<Family_t::Stm32F4> {
+    static constexpr Family_t Family            = Family_t::Stm32F4;
+
+    static constexpr uintptr_t GpioBase         = 0x40020000U;
+    static constexpr uintptr_t GpioStride       = 0x400U;
+    static constexpr uint32_t NumOfPorts        = 9U;           ///< A to I
+    static constexpr bool HasBrr                = false;        ///< pins are reset with the upper half of BSRR
+
+    static constexpr uint16_t getPinMask(Port_t port) {
+        return ((port == Port_t::I) ? 0x0FFFU : 0xFFFFU);
+    }
+
+    static constexpr GpioReset_t getGpioReset(Port_t port) {
+        return ((port == Port_t::A) ? GpioReset_t{0xA8000000U, 0x0C000000U, 0x64000000U} :
+                (port == Port_t::B) ? GpioReset_t{0x00000280U, 0x000000C0U, 0x00000100U} :
+                                      GpioReset_t{0x00000000U, 0x00000000U, 0x00000000U});
+    }
+
+    static constexpr uintptr_t Dma1Base         = 0x40026000U;
+    static constexpr uintptr_t Dma2Base         = 0x40026400U;
+    static constexpr uintptr_t DmaMuxBase       = 0U;           ///< no DMAMUX
+    static constexpr uint32_t NumOfDmaChannels  = 8U;           ///< streams per controller, 8 request channels each
+    static constexpr DmaRouting_t DmaRouting    = DmaRouting_t::ChannelSelect;
+    static constexpr bool Dma1MemToMem          = false;        ///< only DMA2 can copy memory to memory
+};
+
+/**
+ * @brief Device traits with the queries derived from them.
+ */
+template<Family_t F>
+struct Derivative : DeviceTraits<F> {
+    using Traits = DeviceTraits<F>;
+
+    static constexpr uint32_t NumOfPins         = 16U;          ///< per port
+    static constexpr uint32_t NumOfDmaControllers = 2U;
+
+    static constexpr bool hasPort(Port_t port) {
+        return (static_cast<uint32_t>(port) < Traits::NumOfPorts);
+    }
+
+    static constexpr bool hasPin(Port_t port, uint32_t pin) {
+        return (hasPort(port) && (pin < NumOfPins) && (((Traits::getPinMask(port) >> pin) & 1U) != 0U));
+    }
+
+    static constexpr uintptr_t getPortAddress(Port_t port) {
+        return (Traits::GpioBase + static_cast<uintptr_t>(port) * Traits::GpioStride);
+    }
+
+    /// controller is 1 or 2 as in the reference manuals
+    static constexpr uintptr_t getDmaAddress(uint32_t controller) {
+        return ((controller == 1U) ? Traits::Dma1Base : Traits::Dma2Base);
+    }
+};
+
+#if defined(MCAL_DEVICE_STM32F4)
+using Device = Derivative<Family_t::Stm32F4>;      ///< Derivative selected with MCAL_DEVICE
+#elif defined(MCAL_DEVICE_STM32G4)
+using Device = Derivative<Family_t::Stm32G4>;      ///< Derivative selected with MCAL_DEVICE
+#else
+#error "No device family selected, link mcal_device"
+#endif
+
+}   // namespace mcal
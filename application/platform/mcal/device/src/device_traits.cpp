@@ -0,0 +1,67 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "device_traits.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#if defined(MCAL_DEVICE_STM32F4)
+#include "stm32f4xx.h"
+#else
+#include "stm32g4xx.h"
+#endif
+
+namespace mcal {
+
+// The traits of the selected derivative against its CMSIS device header
+static_assert(Device::getPortAddress(Port_t::A) == GPIOA_BASE, "GPIO base address");
+static_assert(Device::getPortAddress(Port_t::B) == GPIOB_BASE, "GPIO port stride");
+static_assert(Device::getPortAddress(Port_t::G) == GPIOG_BASE, "GPIO port stride");
+static_assert(Device::getDmaAddress(1U) == DMA1_BASE, "DMA1 base address");
+static_assert(Device::getDmaAddress(2U) == DMA2_BASE, "DMA2 base address");
+static_assert(Device::hasPin(Port_t::A, 15U) && !Device::hasPin(Port_t::A, 16U), "16 pins per port");
+
+#if defined(MCAL_DEVICE_STM32F4)
+static_assert(Device::NumOfPorts == 9U, "ports A to I");
+static_assert(Device::getPortAddress(Port_t::I) == GPIOI_BASE, "GPIO port stride");
+static_assert(Device::hasPin(Port_t::I, 11U) && !Device::hasPin(Port_t::I, 12U), "PI0 to PI11");
+static_assert(!Device::HasBrr && (sizeof(GPIO_TypeDef) == 10U * sizeof(uint32_t)), "no BRR");
+static_assert(Device::DmaRouting == DmaRouting_t::ChannelSelect, "stream channel selection");
+static_assert(Device::NumOfDmaChannels == ((DMA1_Stream7_BASE - DMA1_Stream0_BASE) / 0x18U + 1U), "8 streams");
+static_assert(Device::getGpioReset(Port_t::B).moder == 0x00000280U, "PB3/PB4 in AF mode (JTAG)");
+#else
+static_assert(Device::NumOfPorts == 7U, "ports A to G");
+static_assert(!Device::hasPort(Port_t::H) && !Device::hasPin(Port_t::H, 0U), "no port H");
+static_assert(Device::hasPin(Port_t::G, 10U) && !Device::hasPin(Port_t::G, 11U), "PG0 to PG10");
+static_assert(Device::HasBrr && (offsetof(GPIO_TypeDef, BRR) == 0x28U), "BRR after AFR");
+static_assert(Device::DmaMuxBase == DMAMUX1_BASE, "DMAMUX base address");
+static_assert(Device::NumOfDmaChannels == ((DMA1_Channel8_BASE - DMA1_Channel1_BASE) / 0x14U + 1U), "8 channels");
+static_assert(Device::getGpioReset(Port_t::A).moder == 0xABFFFFFFU, "PA13/PA14/PA15 in AF mode (SWD/JTAG)");
+#endif
+
+// Both families, independent of the selection
+static_assert(Derivative<Family_t::Stm32F4>::getPortAddress(Port_t::I) == 0x40022000U, "F4 GPIOI");
+static_assert(Derivative<Family_t::Stm32G4>::getPortAddress(Port_t::G) == 0x48001800U, "G4 GPIOG");
+static_assert(!Derivative<Family_t::Stm32F4>::Dma1MemToMem && Derivative<Family_t::Stm32G4>::Dma1MemToMem,
+              "memory to memory transfers on F4 DMA2 only");
+
+}   // namespace mcal
@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "device_traits.h"
+#include "device_register.h"
+#include "gpiomodel.h"
+#include "registerfile.h"
+#include "unittest.h"
+
+using mcal::Derivative;
+using mcal::Device;
+using mcal::Family_t;
+using mcal::Port_t;
+using mcal::sim::GpioModel;
+using mcal::sim::RegisterFile;
+
+namespace {
+
+using G4 = Derivative<Family_t::Stm32G4>;
+using F4 = Derivative<Family_t::Stm32F4>;
+
+constexpr Port_t Ports[] = {Port_t::A, Port_t::B, Port_t::C, Port_t::D, Port_t::E,
+                            Port_t::F, Port_t::G, Port_t::H, Port_t::I};
+
+/// Counts the pins the family reports over all ports and the pin numbers 0..16
+template<typename D>
+uint32_t countPins(void) {
+    uint32_t numOfPins = 0U;
+    for(Port_t port : Ports) {
+        for(uint32_t pin = 0U; pin <= D::NumOfPins; pin++) {
+            numOfPins += D::hasPin(port, pin) ? 1U : 0U;
+        }
+    }
+    return (numOfPins);
+}
+
+void testPortsAndPins(void) {
+    // STM32G474RE: 6 full ports A to F plus PG0..PG10
+    TEST_EQUAL(7U, G4::NumOfPorts);
+    TEST_CHECK(G4::hasPort(Port_t::G) && !G4::hasPort(Port_t::H) && !G4::hasPort(Port_t::I));
+    TEST_CHECK(G4::hasPin(Port_t::G, 10U) && !G4::hasPin(Port_t::G, 11U));
+    TEST_EQUAL(6U * 16U + 11U, countPins<G4>());
+
+    // STM32F407: 8 full ports A to H plus PI0..PI11
+    TEST_EQUAL(9U, F4::NumOfPorts);
+    TEST_CHECK(F4::hasPort(Port_t::I));
+    TEST_CHECK(F4::hasPin(Port_t::I, 11U) && !F4::hasPin(Port_t::I, 12U));
+    TEST_EQUAL(8U * 16U + 12U, countPins<F4>());
+}
+
+void testAddresses(void) {
+    TEST_EQUAL(0x48000000U, G4::getPortAddress(Port_t::A));
+    TEST_EQUAL(0x48000800U, G4::getPortAddress(Port_t::C));
+    TEST_EQUAL(0x40020000U, F4::getPortAddress(Port_t::A));
+    TEST_EQUAL(0x40020800U, F4::getPortAddress(Port_t::C));
+
+    TEST_EQUAL(0x40020000U, G4::getDmaAddress(1U));
+    TEST_EQUAL(0x40020400U, G4::getDmaAddress(2U));
+    TEST_EQUAL(0x40026000U, F4::getDmaAddress(1U));
+    TEST_EQUAL(0x40026400U, F4::getDmaAddress(2U));
+}
+
+void testDma(void) {
+    TEST_EQUAL(mcal::DmaRouting_t::DmaMux, G4::DmaRouting);
+    TEST_EQUAL(0x40020800U, G4::DmaMuxBase);
+    TEST_CHECK(G4::Dma1MemToMem);
+
+    TEST_EQUAL(mcal::DmaRouting_t::ChannelSelect, F4::DmaRouting);
+    TEST_EQUAL(0U, F4::DmaMuxBase);
+    TEST_CHECK(!F4::Dma1MemToMem);
+}
+
+void testGpioReset(void) {
+    // debug pins in alternate function mode, all other pins analog on G4 and input on F4
+    TEST_EQUAL(0xABFFFFFFU, G4::getGpioReset(Port_t::A).moder);
+    TEST_EQUAL(0xFFFFFEBFU, G4::getGpioReset(Port_t::B).moder);
+    TEST_EQUAL(0xFFFFFFFFU, G4::getGpioReset(Port_t::G).moder);
+    TEST_EQUAL(0xA8000000U, F4::getGpioReset(Port_t::A).moder);
+    TEST_EQUAL(0x00000280U, F4::getGpioReset(Port_t::B).moder);
+    TEST_EQUAL(0x00000000U, F4::getGpioReset(Port_t::I).moder);
+    TEST_EQUAL(0x64000000U, G4::getGpioReset(Port_t::A).pupdr);
+    TEST_EQUAL(0x000000C0U, F4::getGpioReset(Port_t::B).ospeedr);
+}
+
+/// The simulated ports of the selected derivative come up with its reset values and its reset register
+void testSelectedDeviceModel(void) {
+    RegisterFile::reset();
+    GpioModel::installAll();
+
+    for(uint32_t port = 0U; port < Device::NumOfPorts; port++) {
+        const uintptr_t base = Device::getPortAddress(static_cast<Port_t>(port));
+        const mcal::GpioReset_t reset = Device::getGpioReset(static_cast<Port_t>(port));
+        TEST_EQUAL(reset.moder, RegisterFile::peek(base + 0x00U));
+        TEST_EQUAL(reset.ospeedr, RegisterFile::peek(base + 0x08U));
+        TEST_EQUAL(reset.pupdr, RegisterFile::peek(base + 0x0CU));
+    }
+
+    const uintptr_t portB = Device::getPortAddress(Port_t::B);
+    RegisterFile::poke(portB + 0x14U, 0x00FFU);
+    mcal::getPeripheral<mcal::device_register>(portB + 0x28U) = 0x0003U;
+    TEST_EQUAL(Device::HasBrr ? 0x00FCU : 0x00FFU, RegisterFile::peek(portB + 0x14U));     // F4 has no register at 0x28
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"ports and pins", testPortsAndPins},
+        {"addresses", testAddresses},
+        {"DMA", testDma},
+        {"GPIO reset values", testGpioReset},
+        {"selected device model", testSelectedDeviceModel},
+    }));
+}
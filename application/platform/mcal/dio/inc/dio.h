@@ -22,12 +22,14 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
-namespace mcal {
+#include "device_register.h"
+#include "device_traits.h"
 
-using device_register = uint32_t volatile;      ///< 32bit device / peripheral register
+namespace mcal {
 
-using GPIO_Port_t = struct GPIOPortRegsiterSet {
+struct GPIOPortRegsiterSet {
     device_register MODER;       /*!< GPIO port mode register,               Address offset: 0x00      */
     device_register OTYPER;      /*!< GPIO port output type register,        Address offset: 0x04      */
     device_register OSPEEDR;     /*!< GPIO port output speed register,       Address offset: 0x08      */
@@ -37,17 +39,32 @@ using GPIO_Port_t = struct GPIOPortRegsiterSet {
     device_register BSRR;        /*!< GPIO port bit set/reset  register,     Address offset: 0x18      */
     device_register LCKR;        /*!< GPIO port configuration lock register, Address offset: 0x1C      */
     device_register AFR[2];      /*!< GPIO alternate function registers,     Address offset: 0x20-0x24 */
+};
+
+struct GPIOPortBrrRegisterSet : GPIOPortRegsiterSet {
     device_register BRR;         /*!< GPIO Bit Reset register,               Address offset: 0x28      */
 };
-static_assert(sizeof(GPIO_Port_t) == (11*sizeof(device_register)), "GPIO_Port_t cointains extra padding bytes!\n");
 
-static GPIO_Port_t& GPIOA = *reinterpret_cast<GPIO_Port_t*>(0x48000000);
-static GPIO_Port_t& GPIOB = *reinterpret_cast<GPIO_Port_t*>(0x48000400);
-static GPIO_Port_t& GPIOC = *reinterpret_cast<GPIO_Port_t*>(0x48000800);
-static GPIO_Port_t& GPIOD = *reinterpret_cast<GPIO_Port_t*>(0x48000C00);
-static GPIO_Port_t& GPIOE = *reinterpret_cast<GPIO_Port_t*>(0x48001000);
-static GPIO_Port_t& GPIOF = *reinterpret_cast<GPIO_Port_t*>(0x48001400);
-static GPIO_Port_t& GPIOG = *reinterpret_cast<GPIO_Port_t*>(0x48001800);
+/// Register set of the selected derivative, BRR only exists where the device has it
+using GPIO_Port_t = std::conditional<Device::HasBrr, GPIOPortBrrRegisterSet, GPIOPortRegsiterSet>::type;
+static_assert(sizeof(GPIO_Port_t) == ((Device::HasBrr ? 11 : 10)*sizeof(device_register)), "GPIO_Port_t cointains extra padding bytes!\n");
+
+/**
+ * @brief Returns the register set of port P, ports the selected device does not have fail to compile.
+ */
+template<Port_t P>
+inline GPIO_Port_t& getPort(void) {
+    static_assert(Device::hasPort(P), "port not available on the selected device");
+    return (getPeripheral<GPIO_Port_t>(Device::getPortAddress(P)));
+}
+
+static GPIO_Port_t& GPIOA = getPort<Port_t::A>();
+static GPIO_Port_t& GPIOB = getPort<Port_t::B>();
+static GPIO_Port_t& GPIOC = getPort<Port_t::C>();
+static GPIO_Port_t& GPIOD = getPort<Port_t::D>();
+static GPIO_Port_t& GPIOE = getPort<Port_t::E>();
+static GPIO_Port_t& GPIOF = getPort<Port_t::F>();
+static GPIO_Port_t& GPIOG = getPort<Port_t::G>();
 
 class IDioPin {
 public:
@@ -75,6 +92,15 @@ public:
 
     ~DioPin(void) = default;
 
+    /**
+     * @brief Returns pin N of port P, pins the selected device does not have fail to compile.
+     */
+    template<Port_t P, Pin_t N>
+    static DioPin create(void) {
+        static_assert(Device::hasPin(P, N), "pin not available on the selected device");
+        return (DioPin(getPort<P>(), N));
+    }
+
     void set (void) override {
         _port.BSRR = (0x00000001 << _pin);
     }
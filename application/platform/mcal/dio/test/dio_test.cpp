@@ -0,0 +1,119 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "dio.h"
+#include "gpiomodel.h"
+#include "registerfile.h"
+#include "unittest.h"
+
+using mcal::DioPin;
+using mcal::IDioPin;
+using mcal::Port_t;
+using mcal::sim::GpioModel;
+using mcal::sim::RegisterFile;
+
+namespace {
+
+constexpr uintptr_t PortA   = mcal::Device::getPortAddress(Port_t::A);
+constexpr uintptr_t PortC   = mcal::Device::getPortAddress(Port_t::C);
+constexpr uintptr_t Odr     = 0x14U;
+constexpr uintptr_t Bsrr    = 0x18U;
+
+void setUp(void) {
+    RegisterFile::reset();
+    GpioModel::installAll();
+}
+
+void testSetIsOneBsrrWrite(void) {
+    setUp();
+    DioPin led = DioPin::create<Port_t::A, IDioPin::Pin5>();
+
+    led.set();
+
+    const auto& trace = RegisterFile::getTrace();
+    TEST_EQUAL(1U, trace.size());
+    TEST_EQUAL(PortA + Bsrr, trace[0].address);
+    TEST_EQUAL(RegisterFile::Access_t::Write, trace[0].access);
+    TEST_EQUAL(1U << 5, trace[0].value);
+    TEST_EQUAL(1U, RegisterFile::getNumOfWrites(PortA + Bsrr));
+    TEST_EQUAL(0U, RegisterFile::getNumOfReads(PortA + Odr));
+    TEST_EQUAL(1U << 5, RegisterFile::peek(PortA + Odr));
+    TEST_EQUAL(0U, RegisterFile::peek(PortA + Bsrr));      // write-only, reads back 0
+}
+
+void testResetIsOneBsrrWrite(void) {
+    setUp();
+    RegisterFile::poke(PortA + Odr, 0x0021U);
+    DioPin led = DioPin::create<Port_t::A, IDioPin::Pin5>();
+
+    led.reset();
+
+    const auto& trace = RegisterFile::getTrace();
+    TEST_EQUAL(1U, trace.size());
+    TEST_EQUAL(PortA + Bsrr, trace[0].address);
+    TEST_EQUAL(RegisterFile::Access_t::Write, trace[0].access);
+    TEST_EQUAL(1U << 21, trace[0].value);
+    TEST_EQUAL(0x0001U, RegisterFile::peek(PortA + Odr));   // other pins keep their level
+}
+
+void testReadIsOneOdrRead(void) {
+    setUp();
+    DioPin led = DioPin::create<Port_t::A, IDioPin::Pin5>();
+
+    TEST_EQUAL(IDioPin::PinState_t::RESET, led.read());
+    led.set();
+    RegisterFile::clearTrace();
+
+    TEST_EQUAL(IDioPin::PinState_t::SET, led.read());
+    const auto& trace = RegisterFile::getTrace();
+    TEST_EQUAL(1U, trace.size());
+    TEST_EQUAL(PortA + Odr, trace[0].address);
+    TEST_EQUAL(RegisterFile::Access_t::Read, trace[0].access);
+    TEST_EQUAL(1U << 5, trace[0].value);
+}
+
+void testToggleThroughInterface(void) {
+    setUp();
+    DioPin button = DioPin::create<Port_t::C, IDioPin::Pin13>();
+    IDioPin& pin = button;
+
+    for(uint32_t i = 0U; i < 10U; i++) {
+        pin.set();
+        pin.reset();
+    }
+
+    TEST_EQUAL(20U, RegisterFile::getNumOfWrites(PortC + Bsrr));
+    TEST_EQUAL(20U, RegisterFile::getTrace().size());
+    TEST_EQUAL(0U, RegisterFile::getNumOfWrites(PortA + Bsrr));
+    TEST_EQUAL(0U, RegisterFile::peek(PortC + Odr));
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"set() is one BSRR write", testSetIsOneBsrrWrite},
+        {"reset() is one BSRR write", testResetIsOneBsrrWrite},
+        {"read() is one ODR read", testReadIsOneOdrRead},
+        {"toggle through IDioPin", testToggleThroughInterface},
+    }));
+}
@@ -0,0 +1,87 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace mcal {
+
+/**
+ * @brief Runtime installation of exception and interrupt handlers.
+ * 
+ * Requires the vector table to be copied to RAM at boot (VECT_TAB_RAM_COPY). Handlers are written
+ * directly into the vector slots, so the CPU branches to them without any dispatcher in between.
+ * Member functions are bound through a trampoline that is generated at compile time for a given
+ * object and method and usually inlines the method call completely.
+ */
+class VectorTable {
+public:
+    using Handler_t = void (*)(void);
+
+    static constexpr int32_t NumOfSystemVectors = 16;      ///< Initial SP, reset and Cortex-M4 exceptions
+    static constexpr int32_t NumOfIrqVectors    = 102;     ///< STM32G474 peripheral interrupts
+
+    VectorTable(void) = delete;
+
+    /**
+     * @brief Installs a handler.
+     * 
+     * @param irqn      CMSIS IRQn_Type value (negative for the Cortex-M4 exceptions)
+     * @param handler   function to be called on the interrupt
+     * @return false if irqn is out of range or the active vector table is not located in RAM
+     */
+    static bool setHandler(int32_t irqn, Handler_t handler);
+
+    /**
+     * @brief Returns the currently installed handler or nullptr if irqn is out of range.
+     */
+    static Handler_t getHandler(int32_t irqn);
+
+    /**
+     * @brief Installs a member function of an object with static storage duration as handler.
+     * 
+     * Usage: VectorTable::bind<uart2, &Uart::onInterrupt>(USART2_IRQn);
+     */
+    template<auto& Object, auto Method>
+    static bool bind(int32_t irqn) {
+        return (setHandler(irqn, &Trampoline<Object, Method>::handler));
+    }
+
+    /**
+     * @brief Returns the vector slot index of irqn or -1 if irqn is out of range.
+     */
+    static constexpr int32_t getIndex(int32_t irqn) {
+        const int32_t index = irqn + NumOfSystemVectors;
+        return (((index < 2) || (index >= (NumOfSystemVectors + NumOfIrqVectors))) ? -1 : index);     // initial SP and reset are not writable
+    }
+
+private:
+    template<auto& Object, auto Method>
+    struct Trampoline {
+        static void handler(void) {
+            (Object.*Method)();
+        }
+    };
+};
+
+}   // namespace mcal
@@ -0,0 +1,92 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vectortable.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#include "cpu.h"
+#include "device_register.h"
+#include "stm32g4xx.h"
+
+namespace mcal {
+
+namespace {
+
+#if defined(MCAL_NATIVE)
+using Vector_t = uintptr_t;     ///< host handler addresses do not fit into 32 bits, the simulated table has wider slots
+#else
+using Vector_t = uint32_t;
+#endif
+
+using VectorSlots_t = Vector_t[VectorTable::NumOfSystemVectors + VectorTable::NumOfIrqVectors];
+
+/// VTOR of the system control block
+inline device_register& getVtor(void) {
+    return (getPeripheral<device_register>(SCB_BASE + offsetof(SCB_Type, VTOR)));
+}
+
+inline VectorSlots_t& getTable(uint32_t vtor) {
+    return (getPeripheral<VectorSlots_t>(vtor));
+}
+
+inline Vector_t* getActiveTable(void) {
+    const uint32_t vtor = getVtor();
+    const bool inCcmsram = (vtor >= CCMSRAM_BASE) && (vtor < (CCMSRAM_BASE + CCMSRAM_SIZE));
+    const bool inSram    = (vtor >= SRAM1_BASE);
+
+    if(!inCcmsram && !inSram) {
+        return (nullptr);       // table in flash, handlers are fixed at link time
+    }
+    return (getTable(vtor));
+}
+
+}   // anonymous namespace
+
+bool VectorTable::setHandler(int32_t irqn, Handler_t handler) {
+    const int32_t index = getIndex(irqn);
+    Vector_t* table = getActiveTable();
+
+    if((index < 0) || (table == nullptr)) {
+        return (false);
+    }
+
+    table[index] = static_cast<Vector_t>(reinterpret_cast<uintptr_t>(handler));
+    cpu::dataSyncBarrier();     // entry must be written before the interrupt can be taken
+    return (true);
+}
+
+VectorTable::Handler_t VectorTable::getHandler(int32_t irqn) {
+    const int32_t index = getIndex(irqn);
+
+    if(index < 0) {
+        return (nullptr);
+    }
+    return (reinterpret_cast<Handler_t>(static_cast<uintptr_t>(getTable(getVtor())[index])));
+}
+
+static_assert(VectorTable::getIndex(NonMaskableInt_IRQn) == 2, "vector index mismatch");
+static_assert(VectorTable::getIndex(NonMaskableInt_IRQn - 1) == -1, "reset vector must not be writable");
+static_assert(VectorTable::getIndex(FMAC_IRQn) == (VectorTable::NumOfSystemVectors + VectorTable::NumOfIrqVectors - 1), "vector index mismatch");
+static_assert(VectorTable::getIndex(FMAC_IRQn + 1) == -1, "vector index mismatch");
+
+}   // namespace mcal
@@ -0,0 +1,117 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "vectortable.h"
+#include "registerfile.h"
+#include "stm32g4xx.h"
+#include "unittest.h"
+
+#include <cstddef>
+
+using mcal::VectorTable;
+using mcal::sim::RegisterFile;
+
+namespace {
+
+constexpr uint32_t VtorAddress = SCB_BASE + offsetof(SCB_Type, VTOR);
+
+class Counter {
+public:
+    void onInterrupt(void) {
+        calls++;
+    }
+
+    uint32_t calls = 0U;
+};
+
+Counter counter;
+uint32_t functionCalls = 0U;
+
+void onFunction(void) {
+    functionCalls++;
+}
+
+void setUp(uint32_t vtor) {
+    RegisterFile::reset();
+    RegisterFile::poke(VtorAddress, vtor);
+}
+
+void testSetAndGetHandler(void) {
+    setUp(SRAM1_BASE);
+
+    TEST_CHECK(VectorTable::setHandler(USART2_IRQn, &onFunction));
+    TEST_CHECK(VectorTable::getHandler(USART2_IRQn) == &onFunction);
+    TEST_CHECK(VectorTable::getHandler(USART1_IRQn) == nullptr);
+
+    functionCalls = 0U;
+    VectorTable::getHandler(USART2_IRQn)();
+    TEST_EQUAL(1U, functionCalls);
+}
+
+void testTableInCcmsram(void) {
+    setUp(CCMSRAM_BASE);
+
+    TEST_CHECK(VectorTable::setHandler(SysTick_IRQn, &onFunction));
+    TEST_CHECK(VectorTable::getHandler(SysTick_IRQn) == &onFunction);
+}
+
+void testBindCallsMethod(void) {
+    setUp(SRAM1_BASE);
+
+    TEST_CHECK((VectorTable::bind<counter, &Counter::onInterrupt>(I2C1_EV_IRQn)));
+    counter.calls = 0U;
+    VectorTable::Handler_t handler = VectorTable::getHandler(I2C1_EV_IRQn);
+    TEST_CHECK(handler != nullptr);
+    handler();
+    handler();
+    TEST_EQUAL(2U, counter.calls);
+}
+
+void testTableInFlashIsRejected(void) {
+    setUp(FLASH_BASE);
+
+    TEST_CHECK(!VectorTable::setHandler(USART2_IRQn, &onFunction));
+    TEST_CHECK(!(VectorTable::bind<counter, &Counter::onInterrupt>(USART2_IRQn)));
+    TEST_CHECK(VectorTable::getHandler(USART2_IRQn) == nullptr);
+}
+
+void testOutOfRange(void) {
+    setUp(SRAM1_BASE);
+
+    TEST_CHECK(!VectorTable::setHandler(NonMaskableInt_IRQn - 1, &onFunction));      // reset vector
+    TEST_CHECK(!VectorTable::setHandler(FMAC_IRQn + 1, &onFunction));
+    TEST_CHECK(VectorTable::getHandler(FMAC_IRQn + 1) == nullptr);
+    TEST_CHECK(VectorTable::setHandler(FMAC_IRQn, &onFunction));                    // last slot
+    TEST_CHECK(VectorTable::setHandler(NonMaskableInt_IRQn, &onFunction));          // first writable slot
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"set and get handler", testSetAndGetHandler},
+        {"table in CCM SRAM", testTableInCcmsram},
+        {"bind calls method", testBindCallsMethod},
+        {"table in flash is rejected", testTableInFlashIsRejected},
+        {"out of range", testOutOfRange},
+    }));
+}
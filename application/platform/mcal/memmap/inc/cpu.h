@@ -0,0 +1,93 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(MCAL_NATIVE)
+#include <atomic>
+#endif
+
+namespace mcal {
+namespace cpu {
+
+/*
+ * Cortex-M4 instructions the drivers need besides the register accesses. The native build has no interrupts and
+ * runs the drivers on a single thread, the barriers become compiler fences and the interrupt lock does nothing.
+ */
+
+/// DSB: all memory and register accesses before it have completed
+inline void dataSyncBarrier(void) {
+#if defined(MCAL_NATIVE)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#else
+    __asm volatile ("dsb 0xF" ::: "memory");
+#endif
+}
+
+/// ISB: instructions after it are fetched again, e.g. after a change of the memory map
+inline void instructionSyncBarrier(void) {
+#if defined(MCAL_NATIVE)
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+    __asm volatile ("isb 0xF" ::: "memory");
+#endif
+}
+
+/// DMB: memory accesses before it are observed before those after it
+inline void dataMemoryBarrier(void) {
+#if defined(MCAL_NATIVE)
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#else
+    __asm volatile ("dmb 0xF" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Disables interrupts for the lifetime of the object and restores the previous state afterwards.
+ */
+class CriticalSection {
+public:
+#if defined(MCAL_NATIVE)
+    CriticalSection(void) : _primask{0U} {}
+    ~CriticalSection(void) = default;
+#else
+    CriticalSection(void) {
+        __asm volatile ("mrs %0, primask" : "=r" (_primask) :: "memory");
+        __asm volatile ("cpsid i" ::: "memory");
+    }
+
+    ~CriticalSection(void) {
+        __asm volatile ("msr primask, %0" :: "r" (_primask) : "memory");
+    }
+#endif
+
+    CriticalSection(const CriticalSection&) = delete;
+    CriticalSection& operator=(const CriticalSection&) = delete;
+
+private:
+    uint32_t _primask;
+};
+
+}   // namespace cpu
+}   // namespace mcal
@@ -0,0 +1,54 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(MCAL_NATIVE)
+#include "registerfile.h"
+#endif
+
+namespace mcal {
+
+#if defined(MCAL_NATIVE)
+using device_register = sim::Register;          ///< 32bit device register, traced by the simulated register file
+#else
+using device_register = uint32_t volatile;      ///< 32bit device / peripheral register
+#endif
+
+/**
+ * @brief Returns the register set T of the peripheral at the physical address.
+ * 
+ * On the target this is the peripheral itself, the native build maps the address into the simulated
+ * register file (see platform/mcal/sim).
+ */
+template<typename T>
+inline T& getPeripheral(uintptr_t address) {
+#if defined(MCAL_NATIVE)
+    return (*static_cast<T*>(sim::RegisterFile::map(address, sizeof(T))));
+#else
+    return (*reinterpret_cast<T*>(address));
+#endif
+}
+
+}   // namespace mcal
@@ -0,0 +1,54 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+/*
+ * Placement of code and data into dedicated memory regions (see STM32G474RETX_FLASH.ld).
+ *
+ * CCMSRAM (32 KB at 0x10000000) runs with zero wait states on the I- and D-bus and is not shared
+ * with the DMA masters, which makes it the place for control loops and their working data.
+ * Code and initialized data are copied from flash by Reset_Handler, CCMRAM_BSS data is zeroed.
+ *
+ * Example:
+ *     CCMRAM_FUNC void controlStep(void);      // declaration, so that callers use a long call
+ *     CCMRAM_BSS  static float history[256];
+ */
+
+/// Function executed from CCMSRAM. long_call is required because flash and CCMSRAM are further apart than a BL can reach.
+#define CCMRAM_FUNC		__attribute__((section(".ccmram_text"), long_call, noinline))
+
+/// Initialized variable in CCMSRAM
+#define CCMRAM_DATA		__attribute__((section(".ccmram_data")))
+
+/// Zero initialized variable in CCMSRAM
+#define CCMRAM_BSS		__attribute__((section(".ccmram_bss")))
+
+/// Variable in main SRAM that is neither initialized nor cleared by the startup code (content survives a reset)
+#define NOINIT			__attribute__((section(".noinit")))
+
+/// Function on the hot path: with -freorder-functions (-O2 and up) it goes to .text.hot, which the linker script places
+/// contiguously at the start of .text to keep the hot code in as few flash accelerator cache lines as possible
+#define HOT_FUNC		__attribute__((hot))
+
+/// Function that is rarely executed (error and fault paths): optimized for size and moved to .text.unlikely
+#define COLD_FUNC		__attribute__((cold))
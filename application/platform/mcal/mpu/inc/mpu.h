@@ -0,0 +1,168 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace mcal {
+
+/**
+ * @brief Cortex-M4 (ARMv7-M) memory protection unit.
+ * 
+ * Regions are encoded at compile time into the RBAR/RASR register values. The MPU runs with the default memory
+ * map as background region, so only the configured regions cost anything, and that is checked in hardware in
+ * parallel to the access. setup() installs the null-pointer trap and the guard region below the main stack.
+ */
+class Mpu {
+public:
+    static constexpr uint32_t NumOfRegions      = 8U;
+    static constexpr uint32_t MinRegionSize     = 32U;
+    static constexpr uint32_t MinSubregionSize  = 256U;    ///< Regions below 256 bytes can not use subregions
+    static constexpr uint32_t NumOfSubregions   = 8U;
+    /// Must match _Stack_Guard_Size of the linker script. A frame larger than the guard jumps over it, 256 bytes
+    /// catch the FP exception frame (104 bytes) plus a handler's locals.
+    static constexpr uint32_t StackGuardSize    = 256U;
+    static constexpr uint32_t NullTrapSize      = 1024U;   ///< Traps null pointers plus member offsets up to 1 KiB
+
+    /// Region numbers used by setup(), higher numbers take precedence on overlaps
+    static constexpr uint32_t NullTrapRegion    = 0U;
+    static constexpr uint32_t StackGuardRegion  = 1U;
+
+    /// AP field: privileged / unprivileged access
+    enum class Access_t : uint8_t {
+        NoAccess        = 0U,
+        PrivRw          = 1U,
+        PrivRwUserRo    = 2U,
+        FullAccess      = 3U,
+        PrivRo          = 5U,
+        ReadOnly        = 6U
+    };
+
+    /// TEX, C and B fields as laid out in RASR from bit 16 on (B, C, S, TEX), not shareable (single core)
+    enum class Memory_t : uint8_t {
+        StronglyOrdered     = 0x00U,    ///< TEX 000, C 0, B 0
+        Device              = 0x01U,    ///< TEX 000, C 0, B 1
+        NormalWriteThrough  = 0x02U,    ///< TEX 000, C 1, B 0
+        NormalWriteBack     = 0x03U,    ///< TEX 000, C 1, B 1
+        NormalNonCacheable  = 0x08U     ///< TEX 001, C 0, B 0
+    };
+
+    struct Region_t {
+        uint32_t rbar;
+        uint32_t rasr;
+    };
+
+    // Register field positions (ARMv7-M), checked against CMSIS in the implementation
+    static constexpr uint32_t RbarValid     = 1U << 4;
+    static constexpr uint32_t RasrEnable    = 1U << 0;
+    static constexpr uint32_t RasrSizePos   = 1U;
+    static constexpr uint32_t RasrSrdPos    = 8U;
+    static constexpr uint32_t RasrBPos      = 16U;
+    static constexpr uint32_t RasrApPos     = 24U;
+    static constexpr uint32_t RasrXn        = 1U << 28;
+
+    Mpu(void) = delete;
+
+    /**
+     * @brief Returns true if bytes is a power of two of at least MinRegionSize and base is aligned to it.
+     */
+    static constexpr bool isValidRegion(uint32_t base, uint32_t bytes) {
+        return ((bytes >= MinRegionSize) && ((bytes & (bytes - 1U)) == 0U) && ((base & (bytes - 1U)) == 0U));
+    }
+
+    /**
+     * @brief Returns the SIZE field for a region of bytes (a power of two): log2(bytes) - 1.
+     */
+    static constexpr uint32_t getSizeField(uint32_t bytes) {
+        uint32_t log2 = 0U;
+        while((bytes >> log2) > 1U) {
+            log2++;
+        }
+        return (log2 - 1U);
+    }
+
+    /**
+     * @brief Returns the subregion disable mask that leaves only the subregions inside [begin, end) enabled.
+     * 
+     * A subregion is enabled only if it is covered completely, so the enabled part never exceeds [begin, end).
+     */
+    static constexpr uint8_t getSubregionMask(uint32_t base, uint32_t bytes, uint32_t begin, uint32_t end) {
+        const uint32_t subregionSize = bytes / NumOfSubregions;
+        uint8_t disable = 0U;
+        for(uint32_t i = 0U; i < NumOfSubregions; i++) {
+            const uint32_t subregionBegin = base + i * subregionSize;
+            if((subregionBegin < begin) || ((subregionBegin + subregionSize) > end)) {
+                disable |= static_cast<uint8_t>(1U << i);
+            }
+        }
+        return (disable);
+    }
+
+    /**
+     * @brief Encodes a region. Use isValidRegion() to check the parameters, subregions require bytes >= 256.
+     */
+    static constexpr Region_t makeRegion(uint32_t number, uint32_t base, uint32_t bytes, Access_t access,
+                                         Memory_t memory, bool executable, uint8_t subregionDisable = 0U) {
+        return (Region_t{
+            (base & ~(MinRegionSize - 1U)) | RbarValid | (number & 0xFU),
+            (executable ? 0U : RasrXn) |
+            (static_cast<uint32_t>(access) << RasrApPos) |
+            (static_cast<uint32_t>(memory) << RasrBPos) |
+            ((bytes >= MinSubregionSize) ? (static_cast<uint32_t>(subregionDisable) << RasrSrdPos) : 0U) |
+            (getSizeField(bytes) << RasrSizePos) |
+            RasrEnable
+        });
+    }
+
+    /**
+     * @brief Encodes a no-access guard of StackGuardSize bytes directly below a downward growing stack.
+     * 
+     * @param stackLimit lowest usable address of the stack, aligned to StackGuardSize
+     */
+    static constexpr Region_t makeStackGuard(uint32_t number, uint32_t stackLimit) {
+        return (makeRegion(number, stackLimit - StackGuardSize, StackGuardSize, Access_t::NoAccess,
+                           Memory_t::NormalWriteBack, false));
+    }
+
+    static void setRegion(const Region_t& region);
+    static void clearRegion(uint32_t number);
+
+    /**
+     * @brief Enables the MPU with the default memory map as background and enables the MemManage fault.
+     */
+    static void enable(void);
+    static void disable(void);
+
+    /**
+     * @brief Installs the null-pointer trap and the main stack guard and enables the MPU.
+     */
+    static void setup(void);
+};
+
+}   // namespace mcal
+
+/**
+ * @brief Calls mcal::Mpu::setup() from the reset handler, right after SystemInit() and before the static
+ * constructors, so the guards are active for everything that runs from C++ code.
+ */
+extern "C" void Mpu_Setup(void);
@@ -0,0 +1,121 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mpu.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#include "cpu.h"
+#include "device_register.h"
+#include "stm32g4xx.h"
+
+extern "C" uint32_t _sstack;        // lowest address of the main stack, defined by the linker script
+
+namespace mcal {
+
+namespace {
+
+struct MpuRegisterSet {
+    device_register TYPE;       /*!< MPU type register,                      Address offset: 0x00 */
+    device_register CTRL;       /*!< MPU control register,                   Address offset: 0x04 */
+    device_register RNR;        /*!< MPU region number register,             Address offset: 0x08 */
+    device_register RBAR;       /*!< MPU region base address register,       Address offset: 0x0C */
+    device_register RASR;       /*!< MPU region attribute and size register, Address offset: 0x10 */
+};
+
+static_assert(offsetof(MpuRegisterSet, RASR) == offsetof(MPU_Type, RASR), "unexpected MPU register layout");
+
+inline MpuRegisterSet& getMpu(void) {
+    return (getPeripheral<MpuRegisterSet>(MPU_BASE));
+}
+
+/// SHCSR of the system control block
+inline device_register& getShcsr(void) {
+    return (getPeripheral<device_register>(SCB_BASE + offsetof(SCB_Type, SHCSR)));
+}
+
+}   // anonymous namespace
+
+static_assert(Mpu::RbarValid == MPU_RBAR_VALID_Msk, "unexpected MPU register layout");
+static_assert(Mpu::RasrEnable == MPU_RASR_ENABLE_Msk, "unexpected MPU register layout");
+static_assert(Mpu::RasrSizePos == MPU_RASR_SIZE_Pos, "unexpected MPU register layout");
+static_assert(Mpu::RasrSrdPos == MPU_RASR_SRD_Pos, "unexpected MPU register layout");
+static_assert(Mpu::RasrBPos == MPU_RASR_B_Pos, "unexpected MPU register layout");
+static_assert(Mpu::RasrApPos == MPU_RASR_AP_Pos, "unexpected MPU register layout");
+static_assert(Mpu::RasrXn == MPU_RASR_XN_Msk, "unexpected MPU register layout");
+
+// Encoding checks
+static_assert(Mpu::getSizeField(32U) == 4U, "32 bytes are SIZE 4");
+static_assert(Mpu::getSizeField(1024U) == 9U, "1 KiB is SIZE 9");
+static_assert(Mpu::getSizeField(0x80000000U) == 30U, "2 GiB is SIZE 30");
+static_assert(Mpu::isValidRegion(0x20000000U, 0x20000U), "aligned power of two");
+static_assert(!Mpu::isValidRegion(0x20000100U, 0x200U), "base not aligned to the size");
+static_assert(!Mpu::isValidRegion(0x20000000U, 0x300U), "not a power of two");
+static_assert(!Mpu::isValidRegion(0x20000000U, 16U), "below the minimum size");
+static_assert(Mpu::getSubregionMask(0x20000000U, 0x800U, 0x20000000U, 0x20000800U) == 0x00U, "all enabled");
+static_assert(Mpu::getSubregionMask(0x20000000U, 0x800U, 0x20000100U, 0x20000700U) == 0x81U, "first and last disabled");
+static_assert(Mpu::getSubregionMask(0x20000000U, 0x800U, 0x20000080U, 0x20000800U) == 0x01U, "partly covered is disabled");
+static_assert(Mpu::makeRegion(1U, 0x2001FBE0U, 32U, Mpu::Access_t::NoAccess, Mpu::Memory_t::NormalWriteBack, false).rbar
+              == 0x2001FBF1U, "RBAR: address, VALID, region");
+static_assert(Mpu::makeRegion(1U, 0x2001FBE0U, 32U, Mpu::Access_t::NoAccess, Mpu::Memory_t::NormalWriteBack, false).rasr
+              == 0x10030009U, "RASR: XN, AP 000, C, B, SIZE 4, ENABLE");
+static_assert(Mpu::makeRegion(2U, 0x20000000U, 256U, Mpu::Access_t::ReadOnly, Mpu::Memory_t::NormalNonCacheable, true, 0x0FU).rasr
+              == 0x06080F0FU, "RASR: AP 110, TEX 001, SRD, SIZE 7, ENABLE");
+static_assert(Mpu::makeRegion(2U, 0x20000000U, 128U, Mpu::Access_t::FullAccess, Mpu::Memory_t::Device, false, 0xFFU).rasr
+              == 0x1301000DU, "RASR: subregions ignored below 256 bytes");
+
+void Mpu::setRegion(const Region_t& region) {
+    MpuRegisterSet& mpu = getMpu();
+    mpu.RBAR = region.rbar;
+    mpu.RASR = region.rasr;
+}
+
+void Mpu::clearRegion(uint32_t number) {
+    MpuRegisterSet& mpu = getMpu();
+    mpu.RNR = number;
+    mpu.RASR = 0U;
+}
+
+void Mpu::enable(void) {
+    getShcsr() |= SCB_SHCSR_MEMFAULTENA_Msk;
+    getMpu().CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    cpu::dataSyncBarrier();
+    cpu::instructionSyncBarrier();
+}
+
+void Mpu::disable(void) {
+    cpu::dataMemoryBarrier();
+    getMpu().CTRL = 0U;
+}
+
+void Mpu::setup(void) {
+    disable();
+    setRegion(makeRegion(NullTrapRegion, 0U, NullTrapSize, Access_t::NoAccess, Memory_t::StronglyOrdered, false));
+    setRegion(makeStackGuard(StackGuardRegion, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&_sstack))));
+    enable();
+}
+
+}   // namespace mcal
+
+extern "C" void Mpu_Setup(void) {
+    mcal::Mpu::setup();
+}
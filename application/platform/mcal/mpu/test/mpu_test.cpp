@@ -0,0 +1,174 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mpu.h"
+#include "registerfile.h"
+#include "stm32g4xx.h"
+#include "unittest.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+using mcal::Mpu;
+using mcal::sim::RegisterFile;
+
+/// Stands in for the linker script symbol, aligned like the main stack
+extern "C" {
+alignas(Mpu::StackGuardSize) uint32_t _sstack;
+}
+
+namespace {
+
+constexpr uintptr_t CtrlAddress  = MPU_BASE + offsetof(MPU_Type, CTRL);
+constexpr uintptr_t RnrAddress   = MPU_BASE + offsetof(MPU_Type, RNR);
+constexpr uintptr_t RbarAddress  = MPU_BASE + offsetof(MPU_Type, RBAR);
+constexpr uintptr_t RasrAddress  = MPU_BASE + offsetof(MPU_Type, RASR);
+constexpr uintptr_t ShcsrAddress = SCB_BASE + offsetof(SCB_Type, SHCSR);
+
+/// Region registers as the MPU latches them: RBAR with VALID selects the region, RASR goes to the selected one
+std::array<Mpu::Region_t, Mpu::NumOfRegions> regions;
+
+void setUp(void) {
+    RegisterFile::reset();
+    regions = {};
+    RegisterFile::setWriteHook(RbarAddress, [](uintptr_t, uint32_t written, uint32_t) {
+        if((written & Mpu::RbarValid) != 0U) {
+            RegisterFile::poke(RnrAddress, written & 0xFU);
+        }
+        const uint32_t rbar = (written & ~0x1FU) | RegisterFile::peek(RnrAddress);
+        regions[RegisterFile::peek(RnrAddress)].rbar = rbar;
+        return (rbar);
+    });
+    RegisterFile::setWriteHook(RasrAddress, [](uintptr_t, uint32_t written, uint32_t) {
+        regions[RegisterFile::peek(RnrAddress)].rasr = written;
+        return (written);
+    });
+}
+
+std::vector<RegisterFile::Event_t> getWrites(void) {
+    std::vector<RegisterFile::Event_t> writes;
+    for(const RegisterFile::Event_t& event : RegisterFile::getTrace()) {
+        if(event.access == RegisterFile::Access_t::Write) {
+            writes.push_back(event);
+        }
+    }
+    return (writes);
+}
+
+uint32_t getStackLimit(void) {
+    return (static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&_sstack)));
+}
+
+void testSetupSequence(void) {
+    setUp();
+
+    Mpu::setup();
+
+    const std::vector<RegisterFile::Event_t> writes = getWrites();
+    TEST_EQUAL(7U, writes.size());
+    TEST_EQUAL(CtrlAddress, writes[0].address);         // disabled while the regions change
+    TEST_EQUAL(0U, writes[0].value);
+    TEST_EQUAL(RbarAddress, writes[1].address);
+    TEST_EQUAL(RasrAddress, writes[2].address);
+    TEST_EQUAL(RbarAddress, writes[3].address);
+    TEST_EQUAL(RasrAddress, writes[4].address);
+    TEST_EQUAL(ShcsrAddress, writes[5].address);        // MemManage enabled before the MPU
+    TEST_EQUAL(CtrlAddress, writes[6].address);
+    TEST_EQUAL(MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk, writes[6].value);
+}
+
+void testNullTrap(void) {
+    setUp();
+
+    Mpu::setup();
+
+    const Mpu::Region_t& region = regions[Mpu::NullTrapRegion];
+    TEST_EQUAL(Mpu::NullTrapRegion, region.rbar);       // base 0
+    TEST_CHECK((region.rasr & Mpu::RasrEnable) != 0U);
+    TEST_CHECK((region.rasr & Mpu::RasrXn) != 0U);
+    TEST_EQUAL(static_cast<uint32_t>(Mpu::Access_t::NoAccess), (region.rasr & MPU_RASR_AP_Msk) >> MPU_RASR_AP_Pos);
+    TEST_EQUAL(Mpu::NullTrapSize, 2U << ((region.rasr & MPU_RASR_SIZE_Msk) >> MPU_RASR_SIZE_Pos));
+    TEST_EQUAL(0U, (region.rasr & MPU_RASR_SRD_Msk));
+}
+
+void testStackGuard(void) {
+    setUp();
+
+    Mpu::setup();
+
+    const Mpu::Region_t& region = regions[Mpu::StackGuardRegion];
+    TEST_EQUAL((getStackLimit() - Mpu::StackGuardSize) | Mpu::StackGuardRegion, region.rbar);
+    TEST_CHECK((region.rasr & Mpu::RasrEnable) != 0U);
+    TEST_CHECK((region.rasr & Mpu::RasrXn) != 0U);
+    TEST_EQUAL(static_cast<uint32_t>(Mpu::Access_t::NoAccess), (region.rasr & MPU_RASR_AP_Msk) >> MPU_RASR_AP_Pos);
+    TEST_EQUAL(Mpu::StackGuardSize, 2U << ((region.rasr & MPU_RASR_SIZE_Msk) >> MPU_RASR_SIZE_Pos));
+}
+
+void testEnableKeepsOtherFaults(void) {
+    setUp();
+    RegisterFile::poke(ShcsrAddress, SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk);
+
+    Mpu::enable();
+
+    TEST_EQUAL(SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk | SCB_SHCSR_MEMFAULTENA_Msk,
+               RegisterFile::peek(ShcsrAddress));
+    TEST_EQUAL(MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk, RegisterFile::peek(CtrlAddress));
+}
+
+void testClearRegion(void) {
+    setUp();
+    Mpu::setup();
+
+    Mpu::clearRegion(Mpu::StackGuardRegion);
+
+    TEST_EQUAL(0U, regions[Mpu::StackGuardRegion].rasr);
+    TEST_CHECK((regions[Mpu::NullTrapRegion].rasr & Mpu::RasrEnable) != 0U);
+}
+
+void testRegionEncoding(void) {
+    setUp();
+
+    // 2 KiB of SRAM1 with the first and the last 256 bytes left to the background map
+    const uint8_t srd = Mpu::getSubregionMask(0x20000000U, 0x800U, 0x20000100U, 0x20000700U);
+    Mpu::setRegion(Mpu::makeRegion(4U, 0x20000000U, 0x800U, Mpu::Access_t::ReadOnly,
+                                   Mpu::Memory_t::NormalWriteThrough, false, srd));
+
+    TEST_EQUAL(0x20000004U, regions[4].rbar);
+    TEST_EQUAL(0x81U, (regions[4].rasr & MPU_RASR_SRD_Msk) >> MPU_RASR_SRD_Pos);
+    TEST_EQUAL(0x800U, 2U << ((regions[4].rasr & MPU_RASR_SIZE_Msk) >> MPU_RASR_SIZE_Pos));
+    TEST_EQUAL(0U, (regions[4].rasr & MPU_RASR_B_Msk));
+    TEST_CHECK((regions[4].rasr & MPU_RASR_C_Msk) != 0U);
+}
+
+}   // namespace
+
+int main(void) {
+    return (unittest::run({
+        {"setup sequence", testSetupSequence},
+        {"null pointer trap", testNullTrap},
+        {"stack guard", testStackGuard},
+        {"enable keeps other faults", testEnableKeepsOtherFaults},
+        {"clear region", testClearRegion},
+        {"region encoding", testRegionEncoding},
+    }));
+}
@@ -0,0 +1,58 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Hand-written CMSIS reference of codegen_reg.cpp, each function with the fewest accesses CMSIS allows
+
+#include "stm32g4xx.h"
+
+extern "C" {
+
+void codegen_enableClocks(void) {
+    RCC->AHB2ENR |= (RCC_AHB2ENR_GPIOAEN | RCC_AHB2ENR_GPIOBEN);
+}
+
+void codegen_setOutput(void) {
+    GPIOA->MODER = (GPIOA->MODER & ~GPIO_MODER_MODE5_Msk) | (1U << GPIO_MODER_MODE5_Pos);
+}
+
+void codegen_setPin(void) {
+    GPIOA->BSRR = GPIO_BSRR_BS5;
+}
+
+void codegen_configPll(uint32_t pllm) {
+    RCC->PLLCFGR = RCC_PLLCFGR_PLLSRC_HSE | ((pllm << RCC_PLLCFGR_PLLM_Pos) & RCC_PLLCFGR_PLLM_Msk) |
+                   (85U << RCC_PLLCFGR_PLLN_Pos) | (0U << RCC_PLLCFGR_PLLR_Pos);
+}
+
+void codegen_switchClock(void) {
+    RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_SW | RCC_CFGR_HPRE)) | RCC_CFGR_SW_PLL | RCC_CFGR_HPRE_DIV2;
+}
+
+uint32_t codegen_readSws(void) {
+    return ((RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos);
+}
+
+bool codegen_isPllReady(void) {
+    return ((RCC->CR & RCC_CR_PLLRDY) == RCC_CR_PLLRDY);
+}
+
+}
@@ -0,0 +1,61 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Register accesses with the reg library, the same functions are written with CMSIS in codegen_cmsis.cpp.
+// tools/codegencompare.py checks that none of them is larger than its CMSIS counterpart.
+
+#include "stm32g474xx_regs.h"
+
+using namespace mcal::stm32g4;
+
+extern "C" {
+
+void codegen_enableClocks(void) {
+    Rcc::Ahb2enr::modify(Rcc::Ahb2enr::Gpioaen::set(), Rcc::Ahb2enr::Gpioben::set());
+}
+
+void codegen_setOutput(void) {
+    Gpioa::Moder::modify(Gpioa::Moder::Mode5::value<1U>());
+}
+
+void codegen_setPin(void) {
+    Gpioa::Bsrr::write(Gpioa::Bsrr::Bs5::set());
+}
+
+void codegen_configPll(uint32_t pllm) {
+    Rcc::Pllcfgr::write(Rcc::Pllcfgr::Pllsrc::value<3U>(), Rcc::Pllcfgr::Pllm::value(pllm),
+                        Rcc::Pllcfgr::Plln::value<85U>(), Rcc::Pllcfgr::Pllr::value<0U>());
+}
+
+void codegen_switchClock(void) {
+    Rcc::Cfgr::modify(Rcc::Cfgr::Sw::value<3U>(), Rcc::Cfgr::Hpre::value<8U>());
+}
+
+uint32_t codegen_readSws(void) {
+    return (Rcc::Cfgr::read<Rcc::Cfgr::Sws>());
+}
+
+bool codegen_isPllReady(void) {
+    return (Rcc::Cr::isSet<Rcc::Cr::Pllrdy>());
+}
+
+}
@@ -0,0 +1,167 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "device_register.h"
+
+namespace mcal {
+namespace reg {
+
+/**
+ * Compile time register / field access.
+ *
+ * A register is a type with its address, a field a type with its register, position and width. All fields
+ * passed to one write() or modify() are combined at compile time: the masks are constants, so the fields end up in
+ * a single store or a single read-modify-write, and a field that covers the whole register needs no read at all.
+ * Fields of another register, overlapping fields, writes to read-only fields and constant values wider than the
+ * field do not compile.
+ *
+ * Example:
+ *     Rcc::Ahb2enr::modify(Rcc::Ahb2enr::Gpioaen::set(), Rcc::Ahb2enr::Gpioben::set());
+ *     Gpioa::Moder::modify(Gpioa::Moder::Mode5::value<1U>());
+ */
+
+enum class Access_t : uint8_t {
+    ReadWrite,
+    ReadOnly,
+    WriteOnly
+};
+
+/// Mask of width bits from bit pos on
+constexpr uint32_t makeMask(uint32_t pos, uint32_t width) {
+    return (((width >= 32U) ? 0xFFFFFFFFU : ((1U << width) - 1U)) << pos);
+}
+
+constexpr uint32_t countBits(uint32_t value) {
+    uint32_t count = 0U;
+    while(value != 0U) {
+        value &= (value - 1U);
+        count++;
+    }
+    return (count);
+}
+
+/// Value of field F, already shifted to the field position
+template<typename F>
+struct FieldValue {
+    using Field_t = F;
+    uint32_t bits;
+};
+
+template<typename R, uint32_t Pos, uint32_t Width, typename T = uint32_t, Access_t A = Access_t::ReadWrite>
+struct Field {
+    static_assert((Width > 0U) && ((Pos + Width) <= 32U), "field exceeds the register");
+
+    using Register_t = R;
+    using Value_t = T;
+
+    static constexpr uint32_t Position  = Pos;
+    static constexpr uint32_t Mask      = makeMask(Pos, Width);
+    static constexpr uint32_t MaxValue  = Mask >> Pos;
+    static constexpr Access_t Access    = A;
+
+    /// Constant value, checked at compile time
+    template<T V>
+    static constexpr FieldValue<Field> value(void) {
+        static_assert(static_cast<uint32_t>(V) <= MaxValue, "value does not fit into the field");
+        return (FieldValue<Field>{static_cast<uint32_t>(V) << Pos});
+    }
+
+    /// Runtime value, truncated to the field width
+    static constexpr FieldValue<Field> value(T v) {
+        return (FieldValue<Field>{(static_cast<uint32_t>(v) << Pos) & Mask});
+    }
+
+    static constexpr FieldValue<Field> set(void) {
+        static_assert(Width == 1U, "set() is for single bit fields, use value<>()");
+        return (FieldValue<Field>{Mask});
+    }
+
+    static constexpr FieldValue<Field> clear(void) {
+        return (FieldValue<Field>{0U});
+    }
+};
+
+template<uintptr_t A, uint32_t ResetValue = 0U>
+struct Register {
+    static constexpr uintptr_t Address = A;
+    static constexpr uint32_t Reset = ResetValue;
+
+    static device_register& get(void) {
+        return (getPeripheral<device_register>(A));
+    }
+
+    static uint32_t read(void) {
+        return (get());
+    }
+
+    /// Value of field F
+    template<typename F>
+    static typename F::Value_t read(void) {
+        static_assert(F::Register_t::Address == A, "field of another register");
+        static_assert(F::Access != Access_t::WriteOnly, "field is write-only");
+        return (static_cast<typename F::Value_t>((static_cast<uint32_t>(get()) & F::Mask) >> F::Position));
+    }
+
+    /// True if all bits of the single bit or multi bit fields are set
+    template<typename... F>
+    static bool isSet(void) {
+        constexpr uint32_t mask = (F::Mask | ...);
+        return ((static_cast<uint32_t>(get()) & mask) == mask);
+    }
+
+    /// Stores the fields with a single write, all other bits get their reset value
+    template<typename... F>
+    static void write(FieldValue<F>... values) {
+        checkWrite<F...>();
+        get() = (ResetValue & ~(F::Mask | ... | 0U)) | (values.bits | ... | 0U);
+    }
+
+    /// Changes the fields with a single read-modify-write, or a single write if they cover the whole register
+    template<typename... F>
+    static void modify(FieldValue<F>... values) {
+        checkWrite<F...>();
+        constexpr uint32_t mask = (F::Mask | ... | 0U);
+        const uint32_t bits = (values.bits | ... | 0U);
+        if constexpr (mask == 0xFFFFFFFFU) {
+            get() = bits;
+        } else {
+            get() = (static_cast<uint32_t>(get()) & ~mask) | bits;
+        }
+    }
+
+private:
+    template<typename... F>
+    static constexpr void checkWrite(void) {
+        static_assert(sizeof...(F) > 0U, "no field given");
+        static_assert(((F::Register_t::Address == A) && ...), "field of another register");
+        static_assert(((F::Access != Access_t::ReadOnly) && ...), "field is read-only");
+        static_assert(countBits((F::Mask | ...)) == (countBits(F::Mask) + ...), "fields overlap");
+    }
+};
+
+}   // namespace reg
+}   // namespace mcal
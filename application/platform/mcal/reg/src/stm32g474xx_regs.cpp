@@ -0,0 +1,51 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "stm32g474xx_regs.h"		// Include own header first because it needs to compile in isolation
+
+#include <cstddef>
+
+#include "device_traits.h"
+#include "stm32g4xx.h"
+
+namespace mcal {
+namespace stm32g4 {
+
+// Addresses and field masks of all registers are checked by the generated stm32g474xx_regs_check.cpp, here only
+// the parts not taken from the CMSIS header
+static_assert(Gpiob::Moder::Address == Device::getPortAddress(Port_t::B), "GPIO map and device traits differ");
+static_assert(Gpioa::Moder::Reset == Device::getGpioReset(Port_t::A).moder, "GPIOA MODER reset value");
+static_assert(Gpiob::Moder::Reset == Device::getGpioReset(Port_t::B).moder, "GPIOB MODER reset value");
+static_assert(Gpioc::Moder::Reset == Device::getGpioReset(Port_t::C).moder, "GPIOC MODER reset value");
+static_assert(Gpioa::Pupdr::Reset == Device::getGpioReset(Port_t::A).pupdr, "GPIOA PUPDR reset value");
+static_assert(Gpioa::Bsrr::Bs5::Access == reg::Access_t::WriteOnly, "BSRR is write-only");
+static_assert(Rcc::Cr::Hserdy::Access == reg::Access_t::ReadOnly, "HSERDY is read-only");
+
+// Compile time values
+static_assert(Rcc::Pllcfgr::Plln::value<85U>().bits == (85U << RCC_PLLCFGR_PLLN_Pos), "PLLN = 85");
+static_assert(Rcc::Pllcfgr::Plln::MaxValue == 127U, "PLLN is 7 bits wide");
+static_assert(Rcc::Pllcfgr::Pllm::value(0x1FU).bits == RCC_PLLCFGR_PLLM_Msk, "runtime values are truncated");
+static_assert(Rcc::Cr::Hseon::set().bits == RCC_CR_HSEON, "single bit field");
+static_assert(reg::countBits(GPIO_MODER_MODE5_Msk) == 2U, "bit count");
+
+}   // namespace stm32g4
+}   // namespace mcal
@@ -0,0 +1,52 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+namespace mcal {
+namespace sim {
+
+/**
+ * @brief Hardware behavior of the GPIO ports of the selected derivative in the simulated register file.
+ * 
+ * Presets the reset values of the port and installs the hooks of the write-only registers: BSRR sets and
+ * resets ODR bits (set wins if both are written) and, on devices with BRR, BRR resets them; both read back as 0.
+ * IDR follows ODR for pins in output mode, analog pins read 0 and all other pins the levels given by setInput().
+ */
+class GpioModel {
+public:
+    GpioModel(void) = delete;
+
+    /// Installs the model on the port at base, call after RegisterFile::reset()
+    static void install(uintptr_t base);
+
+    /// Installs the model on all ports of the device
+    static void installAll(void);
+
+    /// Sets the external levels of the input pins of the port at base
+    static void setInput(uintptr_t base, uint16_t levels);
+};
+
+}   // namespace sim
+}   // namespace mcal
@@ -0,0 +1,138 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace mcal {
+namespace sim {
+
+class Register;
+
+/**
+ * @brief Simulated peripheral address space of the native (host) build.
+ * 
+ * Peripheral blocks are allocated on first use and stay at the same host address for the whole run, so the
+ * static port references of the drivers remain valid across reset(). Every register access of a driver is
+ * recorded with its physical address in the trace, and can run a side-effect hook that models the hardware
+ * behavior (e.g. a BSRR write updating ODR).
+ */
+class RegisterFile {
+public:
+    static constexpr uintptr_t PageSize = 0x1000U;   ///< Granularity of the simulated blocks, a map() must not cross it
+
+    enum class Access_t : uint8_t {
+        Read,
+        Write
+    };
+
+    struct Event_t {
+        uintptr_t address;          ///< Physical address of the register
+        Access_t  access;
+        uint32_t  value;            ///< Value returned to / written by the driver
+    };
+
+    /// Returns the value the driver reads, stored is the current register content
+    using ReadHook_t = std::function<uint32_t(uintptr_t address, uint32_t stored)>;
+    /// Returns the new register content after the driver wrote written, e.g. 0 for write-only or w1c registers
+    using WriteHook_t = std::function<uint32_t(uintptr_t address, uint32_t written, uint32_t stored)>;
+
+    RegisterFile(void) = delete;
+
+    /**
+     * @brief Returns the host storage of size bytes at the physical address, allocates the block on first use.
+     * 
+     * Throws std::invalid_argument if the address is not word aligned or the range crosses a PageSize boundary.
+     */
+    static void* map(uintptr_t address, size_t size);
+
+    /// Reads or writes the register at address without tracing and without hooks, e.g. to preset reset values
+    static uint32_t peek(uintptr_t address);
+    static void poke(uintptr_t address, uint32_t value);
+
+    /// Installs (or with an empty function removes) the side-effect hook of a register
+    static void setReadHook(uintptr_t address, ReadHook_t hook);
+    static void setWriteHook(uintptr_t address, WriteHook_t hook);
+
+    static const std::vector<Event_t>& getTrace(void);
+    static size_t getNumOfReads(uintptr_t address);
+    static size_t getNumOfWrites(uintptr_t address);
+    static void clearTrace(void);
+    static void setTracing(bool enabled);
+
+    /**
+     * @brief Clears all registers to 0, removes all hooks and clears the trace. The blocks stay mapped.
+     */
+    static void reset(void);
+
+    /// Access path of Register, runs the hooks and records the trace
+    static uint32_t read(const Register& reg);
+    static void write(Register& reg, uint32_t value);
+};
+
+/**
+ * @brief 32bit device register of the native build.
+ * 
+ * Same size and layout as the uint32_t volatile of the target, so the register set structs map unchanged.
+ * Every conversion is one traced read, every assignment one traced write and a compound assignment is a
+ * read followed by a write, just like the load / store sequence of a volatile access on the target.
+ */
+class Register final {
+public:
+    Register(void) = default;
+    Register(const Register&) = delete;
+    Register& operator=(const Register&) = delete;
+
+    operator uint32_t(void) const {
+        return (RegisterFile::read(*this));
+    }
+
+    Register& operator=(uint32_t value) {
+        RegisterFile::write(*this, value);
+        return (*this);
+    }
+
+    Register& operator|=(uint32_t value) {
+        return (*this = (RegisterFile::read(*this) | value));
+    }
+
+    Register& operator&=(uint32_t value) {
+        return (*this = (RegisterFile::read(*this) & value));
+    }
+
+    Register& operator^=(uint32_t value) {
+        return (*this = (RegisterFile::read(*this) ^ value));
+    }
+
+private:
+    friend class RegisterFile;
+
+    uint32_t _value;
+};
+static_assert(sizeof(Register) == sizeof(uint32_t), "Register must have the layout of a device register");
+
+}   // namespace sim
+}   // namespace mcal
@@ -0,0 +1,103 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "gpiomodel.h"		// Include own header first because it needs to compile in isolation
+
+#include "device_traits.h"
+#include "registerfile.h"
+
+#include <unordered_map>
+
+namespace mcal {
+namespace sim {
+
+namespace {
+
+// Register offsets of the GPIO port register set
+constexpr uintptr_t Moder   = 0x00U;
+constexpr uintptr_t Ospeedr = 0x08U;
+constexpr uintptr_t Pupdr   = 0x0CU;
+constexpr uintptr_t Idr     = 0x10U;
+constexpr uintptr_t Odr     = 0x14U;
+constexpr uintptr_t Bsrr    = 0x18U;
+constexpr uintptr_t Brr     = 0x28U;
+
+constexpr uint32_t ModeOutput = 0x1U;
+constexpr uint32_t ModeAnalog = 0x3U;
+
+std::unordered_map<uintptr_t, uint16_t>& getInputs(void) {
+    static std::unordered_map<uintptr_t, uint16_t> inputs;
+    return (inputs);
+}
+
+uint32_t getModeMask(uint32_t moder, uint32_t mode) {
+    uint32_t mask = 0U;
+    for(uint32_t pin = 0U; pin < 16U; pin++) {
+        if(((moder >> (2U * pin)) & 0x3U) == mode) {
+            mask |= (1U << pin);
+        }
+    }
+    return (mask);
+}
+
+}   // namespace
+
+void GpioModel::install(uintptr_t base) {
+    const GpioReset_t reset = Device::getGpioReset(static_cast<Port_t>((base - Device::GpioBase) / Device::GpioStride));
+    RegisterFile::poke(base + Moder, reset.moder);
+    RegisterFile::poke(base + Ospeedr, reset.ospeedr);
+    RegisterFile::poke(base + Pupdr, reset.pupdr);
+    getInputs()[base] = 0U;
+
+    RegisterFile::setReadHook(base + Idr, [base](uintptr_t, uint32_t) {
+        const uint32_t moder = RegisterFile::peek(base + Moder);
+        const uint32_t outputs = getModeMask(moder, ModeOutput);
+        const uint32_t inputs = ~(outputs | getModeMask(moder, ModeAnalog)) & 0xFFFFU;
+        return ((RegisterFile::peek(base + Odr) & outputs) | (getInputs()[base] & inputs));
+    });
+
+    RegisterFile::setWriteHook(base + Bsrr, [base](uintptr_t, uint32_t written, uint32_t) {
+        const uint32_t odr = RegisterFile::peek(base + Odr);
+        RegisterFile::poke(base + Odr, ((odr & ~(written >> 16U)) | written) & 0xFFFFU);
+        return (0U);
+    });
+
+    if(Device::HasBrr) {
+        RegisterFile::setWriteHook(base + Brr, [base](uintptr_t, uint32_t written, uint32_t) {
+            RegisterFile::poke(base + Odr, RegisterFile::peek(base + Odr) & ~written & 0xFFFFU);
+            return (0U);
+        });
+    }
+}
+
+void GpioModel::installAll(void) {
+    for(uint32_t port = 0U; port < Device::NumOfPorts; port++) {
+        install(Device::getPortAddress(static_cast<Port_t>(port)));
+    }
+}
+
+void GpioModel::setInput(uintptr_t base, uint16_t levels) {
+    getInputs()[base] = levels;
+}
+
+}   // namespace sim
+}   // namespace mcal
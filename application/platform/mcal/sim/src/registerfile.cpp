@@ -0,0 +1,196 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "registerfile.h"		// Include own header first because it needs to compile in isolation
+
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mcal {
+namespace sim {
+
+namespace {
+
+constexpr size_t NumOfPageRegisters = RegisterFile::PageSize / sizeof(Register);
+
+struct Counter_t {
+    size_t reads;
+    size_t writes;
+};
+
+struct State_t {
+    std::map<uintptr_t, std::unique_ptr<Register[]>> pages;     ///< physical page address -> storage
+    std::map<const Register*, uintptr_t> physical;              ///< storage -> physical page address
+    std::unordered_map<uintptr_t, RegisterFile::ReadHook_t> readHooks;
+    std::unordered_map<uintptr_t, RegisterFile::WriteHook_t> writeHooks;
+    std::unordered_map<uintptr_t, Counter_t> counters;
+    std::vector<RegisterFile::Event_t> trace;
+    bool tracing = true;
+};
+
+// Function local so the drivers' static port references can map their registers during static initialization
+State_t& getState(void) {
+    static State_t state;
+    return (state);
+}
+
+Register& getRegister(uintptr_t address) {
+    return (*static_cast<Register*>(RegisterFile::map(address, sizeof(Register))));
+}
+
+uintptr_t getAddress(const Register& reg) {
+    const State_t& state = getState();
+    auto page = state.physical.upper_bound(&reg);
+    if(page == state.physical.begin()) {
+        throw std::logic_error("register is not part of the register file");
+    }
+    --page;
+    const uintptr_t offset = reinterpret_cast<uintptr_t>(&reg) - reinterpret_cast<uintptr_t>(page->first);
+    if(offset >= RegisterFile::PageSize) {
+        throw std::logic_error("register is not part of the register file");
+    }
+    return (page->second + offset);
+}
+
+void record(uintptr_t address, RegisterFile::Access_t access, uint32_t value) {
+    State_t& state = getState();
+    if(!state.tracing) {
+        return;
+    }
+    Counter_t& counter = state.counters[address];
+    if(access == RegisterFile::Access_t::Read) {
+        counter.reads++;
+    } else {
+        counter.writes++;
+    }
+    state.trace.push_back({address, access, value});
+}
+
+}   // namespace
+
+void* RegisterFile::map(uintptr_t address, size_t size) {
+    const uintptr_t base = address & ~(PageSize - 1U);
+    if(((address % sizeof(Register)) != 0U) || (size == 0U) || ((address - base + size) > PageSize)) {
+        throw std::invalid_argument("register block is not word aligned or crosses a page");
+    }
+
+    State_t& state = getState();
+    auto page = state.pages.find(base);
+    if(page == state.pages.end()) {
+        page = state.pages.emplace(base, std::unique_ptr<Register[]>(new Register[NumOfPageRegisters]())).first;
+        state.physical.emplace(page->second.get(), base);
+    }
+    return (&page->second[(address - base) / sizeof(Register)]);
+}
+
+uint32_t RegisterFile::peek(uintptr_t address) {
+    return (getRegister(address)._value);
+}
+
+void RegisterFile::poke(uintptr_t address, uint32_t value) {
+    getRegister(address)._value = value;
+}
+
+void RegisterFile::setReadHook(uintptr_t address, ReadHook_t hook) {
+    if(hook) {
+        getState().readHooks[address] = std::move(hook);
+    } else {
+        getState().readHooks.erase(address);
+    }
+}
+
+void RegisterFile::setWriteHook(uintptr_t address, WriteHook_t hook) {
+    if(hook) {
+        getState().writeHooks[address] = std::move(hook);
+    } else {
+        getState().writeHooks.erase(address);
+    }
+}
+
+const std::vector<RegisterFile::Event_t>& RegisterFile::getTrace(void) {
+    return (getState().trace);
+}
+
+size_t RegisterFile::getNumOfReads(uintptr_t address) {
+    const State_t& state = getState();
+    const auto counter = state.counters.find(address);
+    return ((counter != state.counters.end()) ? counter->second.reads : 0U);
+}
+
+size_t RegisterFile::getNumOfWrites(uintptr_t address) {
+    const State_t& state = getState();
+    const auto counter = state.counters.find(address);
+    return ((counter != state.counters.end()) ? counter->second.writes : 0U);
+}
+
+void RegisterFile::clearTrace(void) {
+    State_t& state = getState();
+    state.trace.clear();
+    state.counters.clear();
+}
+
+void RegisterFile::setTracing(bool enabled) {
+    getState().tracing = enabled;
+}
+
+void RegisterFile::reset(void) {
+    State_t& state = getState();
+    for(auto& page : state.pages) {
+        for(size_t i = 0U; i < NumOfPageRegisters; i++) {
+            page.second[i]._value = 0U;
+        }
+    }
+    state.readHooks.clear();
+    state.writeHooks.clear();
+    clearTrace();
+}
+
+uint32_t RegisterFile::read(const Register& reg) {
+    const uintptr_t address = getAddress(reg);
+    const State_t& state = getState();
+    uint32_t value = reg._value;
+
+    const auto hook = state.readHooks.find(address);
+    if(hook != state.readHooks.end()) {
+        value = hook->second(address, value);
+    }
+    record(address, Access_t::Read, value);
+    return (value);
+}
+
+void RegisterFile::write(Register& reg, uint32_t value) {
+    const uintptr_t address = getAddress(reg);
+    const State_t& state = getState();
+
+    record(address, Access_t::Write, value);
+    const auto hook = state.writeHooks.find(address);
+    if(hook != state.writeHooks.end()) {
+        reg._value = hook->second(address, value, reg._value);
+    } else {
+        reg._value = value;
+    }
+}
+
+}   // namespace sim
+}   // namespace mcal
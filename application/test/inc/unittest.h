@@ -0,0 +1,110 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <type_traits>
+
+namespace unittest {
+
+/**
+ * Minimal checks for the host unit tests, no framework needed.
+ *
+ * A failed check prints its location and the test continues, run() executes the test functions in order and
+ * returns the exit code for ctest.
+ *
+ * Example:
+ *     void testSet(void) {
+ *         TEST_EQUAL(1U, RegisterFile::getNumOfWrites(bsrr));
+ *     }
+ *
+ *     int main(void) {
+ *         return (unittest::run({{"set", testSet}}));
+ *     }
+ */
+
+struct Test_t {
+    const char* name;
+    void (*function)(void);
+};
+
+inline uint32_t& getNumOfFailures(void) {
+    static uint32_t failures = 0U;
+    return (failures);
+}
+
+inline bool check(bool passed, const char* expression, const char* file, int line) {
+    if(!passed) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        getNumOfFailures()++;
+    }
+    return (passed);
+}
+
+/// Integral and enum values are printed, everything else only by its expression
+template<typename T>
+void print(const char* label, const T& value) {
+    if constexpr (std::is_enum_v<T>) {
+        print(label, static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_same_v<T, bool>) {
+        std::fprintf(stderr, "    %s: %s\n", label, value ? "true" : "false");
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        std::fprintf(stderr, "    %s: %lld\n", label, static_cast<long long>(value));
+    } else if constexpr (std::is_integral_v<T>) {
+        std::fprintf(stderr, "    %s: %llu (0x%llX)\n", label, static_cast<unsigned long long>(value),
+                     static_cast<unsigned long long>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        std::fprintf(stderr, "    %s: %g\n", label, static_cast<double>(value));
+    } else if constexpr (std::is_pointer_v<T>) {
+        std::fprintf(stderr, "    %s: %p\n", label, static_cast<const void*>(value));
+    }
+}
+
+template<typename E, typename A>
+bool checkEqual(const E& expected, const A& actual, const char* expression, const char* file, int line) {
+    if(!check(expected == actual, expression, file, line)) {
+        print("expected", expected);
+        print("actual  ", actual);
+        return (false);
+    }
+    return (true);
+}
+
+/**
+ * @brief Runs the tests in order and returns 0 if all checks passed, 1 otherwise.
+ */
+inline int run(std::initializer_list<Test_t> tests) {
+    for(const Test_t& test : tests) {
+        const uint32_t failures = getNumOfFailures();
+        test.function();
+        std::printf("%s %s\n", (getNumOfFailures() == failures) ? "[ OK ]  " : "[ FAIL ]", test.name);
+    }
+    return ((getNumOfFailures() == 0U) ? 0 : 1);
+}
+
+}   // namespace unittest
+
+#define TEST_CHECK(expression)          ::unittest::check((expression), #expression, __FILE__, __LINE__)
+#define TEST_EQUAL(expected, actual)    ::unittest::checkEqual((expected), (actual), #expected " == " #actual, __FILE__, __LINE__)
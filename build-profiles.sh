@@ -0,0 +1,68 @@
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+###########################################################################################
+
+# Builds the firmware with every optimization profile into build-<profile>/ and compares the image sizes and the
+# speed: the instructions executed by all kernels of the benchmark firmware (application/bench) under Renode.
+# With PGO_PROFILE_DIR set (profiles of pgo/), ReleasePGO is Release with -fprofile-use, the before/after of the
+# profile on the target next to the Release row.
+# Usage: [PGO_PROFILE_DIR=<dir>] ./build-profiles.sh [profile ...]
+
+DEFAULT_PROFILES="Debug Release ReleaseLTO MinSizeRel MinSizeRelLTO HotCold"
+if [ -n "${PGO_PROFILE_DIR}" ]; then
+	DEFAULT_PROFILES="${DEFAULT_PROFILES} ReleasePGO"
+fi
+PROFILES=${*:-${DEFAULT_PROFILES}}
+REPORT=build-profiles.txt
+
+printf "%-16s %10s %10s %10s %10s %14s\n" profile text data bss flash instructions > ${REPORT}
+for PROFILE in ${PROFILES}; do
+	BUILD=build-${PROFILE}
+	BUILD_TYPE=${PROFILE}
+	PROFILE_DIR=
+	if [ "${PROFILE}" = "ReleasePGO" ]; then
+		BUILD_TYPE=Release
+		PROFILE_DIR=$(realpath ${PGO_PROFILE_DIR}) || exit 1
+	fi
+	cmake -S . -B ${BUILD}/ -DCMAKE_TOOLCHAIN_FILE=../cmake/cm4.cmake -DCMAKE_BUILD_TYPE=${BUILD_TYPE} \
+		-DPGO_PROFILE_DIR=${PROFILE_DIR} || exit 1
+	cmake --build ${BUILD}/ --target Hello_Stm32 Hello_Stm32_bench || exit 1
+
+	# The tools of the toolchain file, they are not necessarily in PATH
+	SIZE=$(sed -n 's/^CMAKE_SIZE:INTERNAL=//p' ${BUILD}/CMakeCache.txt)
+	NM=$(sed -n 's/^CMAKE_NM:INTERNAL=//p' ${BUILD}/CMakeCache.txt)
+	RENODE=$(sed -n 's/^RENODE:FILEPATH=//p' ${BUILD}/CMakeCache.txt)
+
+	# The bench thresholds belong to one build type: the counts are measured into a scratch threshold file instead
+	INSTRUCTIONS=-
+	if command -v ${RENODE} > /dev/null; then
+		python3 tools/bench.py ${BUILD}/application/bench/Hello_Stm32_bench --nm ${NM} --renode ${RENODE} \
+			--platform application/bench/stm32g474.repl --thresholds ${BUILD}/bench_profile.json --update-thresholds \
+			--json ${BUILD}/bench_report.json > /dev/null || exit 1
+		INSTRUCTIONS=$(python3 -c 'import json, sys; print(sum(k["instructions"] for k in json.load(open(sys.argv[1]))["kernels"]))' ${BUILD}/bench_report.json)
+	else
+		echo "${RENODE} not found, no speed comparison" >&2
+	fi
+
+	${SIZE} ${BUILD}/application/Hello_Stm32 | awk -v p=${PROFILE} -v i=${INSTRUCTIONS} 'NR == 2 { printf "%-16s %10d %10d %10d %10d %14s\n", p, $1, $2, $3, $1 + $2, i }' >> ${REPORT}
+done
+cat ${REPORT}
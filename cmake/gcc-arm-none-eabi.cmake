@@ -32,9 +32,14 @@ SET(CMAKE_C_COMPILER "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-gcc")
 SET(CMAKE_CXX_COMPILER "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-g++")
 SET(CMAKE_ASM_COMPILER "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-gcc")
 
+# The gcc wrappers of ar/ranlib add the LTO plugin, so that libraries of LTO objects get a symbol index
+SET(CMAKE_AR "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-gcc-ar" CACHE INTERNAL "archiver")
+SET(CMAKE_RANLIB "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-gcc-ranlib" CACHE INTERNAL "ranlib")
+
 SET(CMAKE_OBJCOPY "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-objcopy" CACHE INTERNAL "objcopy tool")
 SET(CMAKE_OBJDUMP "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-objdump" CACHE INTERNAL "objdump tool")
 SET(CMAKE_SIZE "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-size" CACHE INTERNAL "size tool")
+SET(CMAKE_NM "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-nm" CACHE INTERNAL "nm tool")
 SET(CMAKE_DEBUGGER "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-gdb" CACHE INTERNAL "debugger")
 SET(CMAKE_CPPFILT "${TOOLCHAIN_BIN_DIR}/${TOOLCHAIN_PREFIX}-c++filt" CACHE INTERNAL "C++filt")
 
@@ -57,6 +62,30 @@ SET(CMAKE_CXX_FLAGS_RELEASE_INIT "-O3" CACHE INTERNAL "cxx compiler flags releas
 SET(CMAKE_ASM_FLAGS_RELEASE_INIT "" CACHE INTERNAL "asm compiler flags release")
 SET(CMAKE_EXE_LINKER_FLAGS_RELEASE_INIT "" CACHE INTERNAL "linker flags release")
 
+SET(CMAKE_C_FLAGS_MINSIZEREL_INIT "-Os" CACHE INTERNAL "c compiler flags minsizerel")
+SET(CMAKE_CXX_FLAGS_MINSIZEREL_INIT "-Os" CACHE INTERNAL "cxx compiler flags minsizerel")
+SET(CMAKE_ASM_FLAGS_MINSIZEREL_INIT "" CACHE INTERNAL "asm compiler flags minsizerel")
+SET(CMAKE_EXE_LINKER_FLAGS_MINSIZEREL_INIT "" CACHE INTERNAL "linker flags minsizerel")
+
+# Additional build types with link time optimization. CMake has no _INIT defaults for custom build types, the
+# flags are set directly. The optimization level is repeated for the link step, where LTO generates the code.
+SET(CMAKE_C_FLAGS_RELEASELTO "-O3 -flto" CACHE INTERNAL "c compiler flags releaselto")
+SET(CMAKE_CXX_FLAGS_RELEASELTO "-O3 -flto" CACHE INTERNAL "cxx compiler flags releaselto")
+SET(CMAKE_ASM_FLAGS_RELEASELTO "" CACHE INTERNAL "asm compiler flags releaselto")
+SET(CMAKE_EXE_LINKER_FLAGS_RELEASELTO "-O3 -flto" CACHE INTERNAL "linker flags releaselto")
+
+SET(CMAKE_C_FLAGS_MINSIZERELLTO "-Os -flto" CACHE INTERNAL "c compiler flags minsizerellto")
+SET(CMAKE_CXX_FLAGS_MINSIZERELLTO "-Os -flto" CACHE INTERNAL "cxx compiler flags minsizerellto")
+SET(CMAKE_ASM_FLAGS_MINSIZERELLTO "" CACHE INTERNAL "asm compiler flags minsizerellto")
+SET(CMAKE_EXE_LINKER_FLAGS_MINSIZERELLTO "-Os -flto" CACHE INTERNAL "linker flags minsizerellto")
+
+# HOT_FUNC functions (memmap.h) are clustered at the start of .text (.text.hot sections, see linker script) for
+# flash accelerator locality, COLD_FUNC functions are optimized for size and moved behind them (.text.unlikely)
+SET(CMAKE_C_FLAGS_HOTCOLD "-O2 -flto -freorder-functions" CACHE INTERNAL "c compiler flags hotcold")
+SET(CMAKE_CXX_FLAGS_HOTCOLD "-O2 -flto -freorder-functions" CACHE INTERNAL "cxx compiler flags hotcold")
+SET(CMAKE_ASM_FLAGS_HOTCOLD "" CACHE INTERNAL "asm compiler flags hotcold")
+SET(CMAKE_EXE_LINKER_FLAGS_HOTCOLD "-O2 -flto -freorder-functions" CACHE INTERNAL "linker flags hotcold")
+
 SET(CMAKE_FIND_ROOT_PATH "${TOOLCHAIN_DIR}/${TOOLCHAIN_PREFIX}")
 SET(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
 SET(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
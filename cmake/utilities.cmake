@@ -27,4 +27,69 @@ FUNCTION(ADD_BIN_TARGETS TARGET)
     ADD_CUSTOM_TARGET(${TARGET}.srec ALL DEPENDS ${TARGET} COMMAND ${CMAKE_OBJCOPY} -O srec "${TARGET}" ${TARGET}.srec)
     ADD_CUSTOM_TARGET(${TARGET}.bin ALL DEPENDS ${TARGET} COMMAND ${CMAKE_OBJCOPY} -O binary "${TARGET}" ${TARGET}.bin)
     ADD_CUSTOM_TARGET(${TARGET}_size ALL DEPENDS ${TARGET} COMMAND ${CMAKE_SIZE} ${TARGET}.elf)
-ENDFUNCTION()
\ No newline at end of file
+ENDFUNCTION()
+
+# Static worst-case stack depth per entry point from the -fstack-usage output and the call graph of the ELF file.
+# Fails if the thread plus the deepest handler exceeds STACK_LIMIT bytes.
+FUNCTION(ADD_STACK_REPORT_TARGET TARGET STACK_LIMIT)
+	ADD_CUSTOM_TARGET(${TARGET}_stack DEPENDS ${TARGET}
+		COMMAND python3 ${CMAKE_SOURCE_DIR}/tools/stackusage.py --su-dir ${CMAKE_BINARY_DIR} --objdump ${CMAKE_OBJDUMP} --limit ${STACK_LIMIT} $<TARGET_FILE:${TARGET}>
+	)
+ENDFUNCTION()
+
+# Flash/RAM report per component and symbol from the linker map (the target has to be linked with
+# -Wl,-Map=<target>.map) and the symbol table. Compares against BASELINE and fails if BUDGETS are exceeded.
+# <target>_sizebaseline stores the current report as new baseline.
+FUNCTION(ADD_SIZE_REPORT_TARGETS TARGET BASELINE BUDGETS)
+	SET(SIZE_REPORT python3 ${CMAKE_SOURCE_DIR}/tools/sizereport.py ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}.map $<TARGET_FILE:${TARGET}> --nm ${CMAKE_NM} --baseline ${BASELINE})
+	ADD_CUSTOM_TARGET(${TARGET}_sizereport ALL DEPENDS ${TARGET} COMMAND ${SIZE_REPORT} --budgets ${BUDGETS} --json ${TARGET}_size.json)
+	ADD_CUSTOM_TARGET(${TARGET}_sizebaseline DEPENDS ${TARGET} COMMAND ${SIZE_REPORT} --update-baseline)
+ENDFUNCTION()
+
+# Profile guided optimization of TARGET with a host profile (see pgo/CMakeLists.txt). The .gcda files of
+# PROFILE_DIR/<target>/ are copied next to the object files of the matching sources before the target is compiled,
+# where -fprofile-use looks for them. Only the sources with a profile get -fprofile-use, the others are compiled as
+# usual. Needs CMake 3.18 to set the source properties in the directory of TARGET.
+FUNCTION(TARGET_PROFILE_USE TARGET PROFILE_DIR)
+	IF(CMAKE_VERSION VERSION_LESS 3.18)
+		MESSAGE(FATAL_ERROR "[pgo] TARGET_PROFILE_USE needs CMake 3.18 or newer")
+	ENDIF()
+	GET_TARGET_PROPERTY(SOURCES ${TARGET} SOURCES)
+	GET_TARGET_PROPERTY(SOURCE_DIR ${TARGET} SOURCE_DIR)
+	GET_TARGET_PROPERTY(BINARY_DIR ${TARGET} BINARY_DIR)
+	SET(OBJECT_DIR ${BINARY_DIR}/CMakeFiles/${TARGET}.dir)
+	SET(COPY_COMMANDS "")
+	FOREACH(SOURCE ${SOURCES})
+		GET_FILENAME_COMPONENT(NAME ${SOURCE} NAME)
+		GET_FILENAME_COMPONENT(SOURCE_PATH ${SOURCE} ABSOLUTE BASE_DIR ${SOURCE_DIR})
+		FILE(RELATIVE_PATH SOURCE ${SOURCE_DIR} ${SOURCE_PATH})
+		GET_FILENAME_COMPONENT(SUBDIR ${SOURCE} DIRECTORY)
+		IF(EXISTS ${PROFILE_DIR}/${TARGET}/${NAME}.gcda)
+			LIST(APPEND COPY_COMMANDS
+				COMMAND ${CMAKE_COMMAND} -E make_directory ${OBJECT_DIR}/${SUBDIR}
+				COMMAND ${CMAKE_COMMAND} -E copy_if_different ${PROFILE_DIR}/${TARGET}/${NAME}.gcda ${OBJECT_DIR}/${SOURCE}.gcda
+			)
+			# functions whose control flow differs between host and target (inlining decisions) drop their
+			# profile, reported as coverage-mismatch warnings instead of errors
+			SET_PROPERTY(SOURCE ${SOURCE_PATH} TARGET_DIRECTORY ${TARGET} APPEND PROPERTY COMPILE_OPTIONS
+				-fprofile-use -fprofile-correction -Wno-error=coverage-mismatch)
+			MESSAGE(STATUS "[pgo] ${TARGET}: ${NAME}")
+		ENDIF()
+	ENDFOREACH()
+	IF(NOT COPY_COMMANDS)
+		MESSAGE(WARNING "[pgo] no profile for ${TARGET} in ${PROFILE_DIR}")
+		RETURN()
+	ENDIF()
+	ADD_CUSTOM_TARGET(${TARGET}_profile ${COPY_COMMANDS})
+	ADD_DEPENDENCIES(${TARGET} ${TARGET}_profile)
+ENDFUNCTION()
+
+# Runs the benchmark firmware TARGET under the Renode emulator with the platform description PLATFORM
+# (tools/bench.py). The instructions executed per kernel are compared against THRESHOLDS, the report is written
+# to bench_report.json and the target fails if a kernel exceeds its threshold. bench_thresholds stores the
+# measured counts plus a margin as new thresholds.
+FUNCTION(ADD_BENCH_TARGET TARGET PLATFORM THRESHOLDS)
+	SET(BENCH python3 ${CMAKE_SOURCE_DIR}/tools/bench.py $<TARGET_FILE:${TARGET}> --nm ${CMAKE_NM} --renode ${RENODE} --platform ${PLATFORM} --thresholds ${THRESHOLDS})
+	ADD_CUSTOM_TARGET(bench DEPENDS ${TARGET} COMMAND ${BENCH} --json ${CMAKE_BINARY_DIR}/bench_report.json)
+	ADD_CUSTOM_TARGET(bench_thresholds DEPENDS ${TARGET} COMMAND ${BENCH} --update-thresholds)
+ENDFUNCTION()
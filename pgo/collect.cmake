@@ -0,0 +1,38 @@
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+###########################################################################################
+
+# Removes old (CLEAN=ON) or collects the .gcda files of the libraries below OBJECT_ROOT into PROFILE_DIR/<library>/,
+# named by the source file (e.g. memory/tlsf.cpp.gcda)
+
+foreach(LIBRARY ${LIBRARIES})
+	file(GLOB_RECURSE PROFILES ${OBJECT_ROOT}/CMakeFiles/${LIBRARY}.dir/*.gcda)
+	foreach(PROFILE ${PROFILES})
+		if(CLEAN)
+			file(REMOVE ${PROFILE})
+		else()
+			get_filename_component(NAME ${PROFILE} NAME)
+			file(COPY ${PROFILE} DESTINATION ${PROFILE_DIR}/${LIBRARY})
+			message(STATUS "[pgo] ${LIBRARY}/${NAME}")
+		endif()
+	endforeach()
+endforeach()
@@ -0,0 +1,112 @@
+// MIT License
+
+// Copyright (c) 2023 Ralf Hochhausen
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Representative workload of the portable libraries for the profile collection. The allocation pattern follows
+// the firmware: mostly small, short-lived messages and a few long-lived buffers, with occasional reallocation.
+// Linked against the uninstrumented libraries, the printed time per operation compares the build without and with
+// the profile (target compare).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "tlsf.h"
+
+namespace {
+
+constexpr uint32_t NumOfIterations  = 2000000U;
+constexpr uint32_t NumOfSlots       = 256U;
+constexpr uint32_t NumOfRuns        = 5U;       // the fastest run is reported, the others absorb host noise
+
+alignas(8) uint8_t g_sram[96U * 1024U];
+alignas(8) uint8_t g_ccmsram[16U * 1024U];
+
+/// Deterministic pseudo random numbers, the profile must not depend on the host
+uint32_t nextRandom(void) {
+    static uint32_t state = 0x12345678U;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state);
+}
+
+std::size_t nextSize(void) {
+    const uint32_t r = nextRandom();
+    if((r & 0xFU) != 0U) {
+        return (8U + (r >> 8) % 56U);       // messages
+    }
+    if((r & 0xF0U) != 0U) {
+        return (64U + (r >> 8) % 448U);     // transactions
+    }
+    return (512U + (r >> 8) % 4096U);       // buffers
+}
+
+/// Returns the time per operation in ns
+double runTlsf(void) {
+    const auto start = std::chrono::steady_clock::now();
+    mem::Tlsf heap;
+    (void)heap.addArena(g_sram, sizeof(g_sram));
+    (void)heap.addArena(g_ccmsram, sizeof(g_ccmsram));
+    void* slots[NumOfSlots]{};
+
+    for(uint32_t i = 0U; i < NumOfIterations; i++) {
+        const uint32_t r = nextRandom();
+        void*& slot = slots[r % NumOfSlots];
+        if(slot == nullptr) {
+            slot = heap.allocate(nextSize());
+            if(slot != nullptr) {
+                std::memset(slot, 0, 8U);
+            }
+        } else if((r & 0x700U) == 0U) {
+            void* moved = heap.reallocate(slot, nextSize());
+            if(moved != nullptr) {
+                slot = moved;
+            }
+        } else {
+            heap.release(slot);
+            slot = nullptr;
+        }
+    }
+    for(void* slot : slots) {
+        heap.release(slot);
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const mem::Tlsf::Stats_t stats = heap.getStats();
+    if(stats.numOfFailures != 0U) {
+        std::printf("tlsf: %u failures\n", stats.numOfFailures);
+    }
+    return (elapsed.count() / NumOfIterations);
+}
+
+}   // anonymous namespace
+
+int main(void) {
+    double best = runTlsf();
+    for(uint32_t run = 1U; run < NumOfRuns; run++) {
+        const double time = runTlsf();
+        best = (time < best) ? time : best;
+    }
+    std::printf("tlsf: %.1f ns per operation\n", best);
+    return (0);
+}
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Instruction count regression check of the benchmark firmware under the Renode emulator.
+
+The firmware (application/bench) calls Bench_Start(kernel) and Bench_Stop(kernel, cycles) around every benchmark
+kernel and Bench_Done() at the end. Renode hooks the three markers and logs the kernel address (r0) and the DWT
+cycles (r1) with the number of executed instructions; the addresses are resolved to the bench_<name> functions with
+the symbol table. The count of bench_empty (marker overhead) is subtracted from all kernels. The cycles are reported
+for information only, they are null where the core does not count them (the Renode platform has no DWT).
+Instruction counts are deterministic, so every kernel is compared against its threshold without noise; exceeding a
+threshold and a threshold without a measured kernel fail with exit code 1. A kernel without a threshold is reported
+as "no baseline" until --update-thresholds records the thresholds.
+
+Usage: tools/bench.py Hello_Stm32_bench --platform stm32g474.repl --thresholds bench_thresholds.json
+       [--json report.json] [--update-thresholds] [--margin 0.02]
+
+Threshold file:  {"unit": "instructions", "kernels": {"crc32": 2400}}
+"""
+
+import argparse
+import json
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+PREFIX = "bench_"
+OVERHEAD = "empty"
+MARKERS = ("Bench_Start", "Bench_Stop", "Bench_Done")
+
+
+def read_symbols(elf, nm):
+    """Returns {name: address} of the defined functions, the Thumb bit cleared."""
+    output = subprocess.run([nm, "--defined-only", elf], check=True, stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    symbols = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if (len(fields) == 3) and (fields[1] in "tT"):
+            symbols[fields[2]] = int(fields[0], 16) & ~1
+    return symbols
+
+
+def make_script(elf, platform, symbols, log):
+    """Renode monitor script, every marker hook appends '<marker> <r0> <r1> <instructions>' to the log."""
+    lines = [
+        'mach create "bench"',
+        "machine LoadPlatformDescription @{}".format(platform),
+        "sysbus LoadELF @{}".format(elf),
+    ]
+    for marker in MARKERS:
+        hook = ("open(r'{}', 'a').write('{} %d %d %d' % (self.GetRegisterUnsafe(0).RawValue, "
+                "self.GetRegisterUnsafe(1).RawValue, self.ExecutedInstructions) + chr(10))").format(log, marker)
+        lines.append('cpu AddHook 0x{:08x} "{}"'.format(symbols[marker], hook))
+    lines.append("start")
+    return "\n".join(lines) + "\n"
+
+
+def run_renode(renode, script, log, timeout):
+    """Runs the script until the firmware reached Bench_Done, returns the log lines."""
+    process = subprocess.Popen([renode, "--disable-xwt", "--console", "--hide-log", "-e", "include @" + script],
+                               stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    deadline = time.monotonic() + timeout
+    lines = []
+    try:
+        while time.monotonic() < deadline:
+            if os.path.exists(log):
+                with open(log) as file:
+                    lines = file.read().splitlines()
+                if any(line.startswith("Bench_Done") for line in lines):
+                    return lines
+            if process.poll() is not None:
+                break
+            time.sleep(0.2)
+    finally:
+        process.kill()
+        process.wait()
+    sys.exit("error: the firmware did not reach Bench_Done within {} s".format(timeout))
+
+
+def measure(lines, names):
+    """Returns {kernel: instructions} and {kernel: cycles or None} from the marker log, without the overhead of the
+    markers."""
+    counts = {}
+    cycles = {}
+    started = {}
+    for line in lines:
+        marker, address, r1, instructions = line.split()
+        kernel = names.get(int(address) & ~1)
+        if marker == "Bench_Start":
+            started[kernel] = int(instructions)
+        elif (marker == "Bench_Stop") and (kernel in started):
+            counts[kernel] = int(instructions) - started.pop(kernel)
+            cycles[kernel] = int(r1)
+    overhead = counts.pop(OVERHEAD, 0)
+    cycle_overhead = cycles.pop(OVERHEAD, 0)
+    cycles = {kernel: (max(count - cycle_overhead, 0) if count else None) for kernel, count in cycles.items()}
+    return ({kernel: max(count - overhead, 0) for kernel, count in counts.items()}, cycles, overhead)
+
+
+def build_report(counts, cycles, overhead, thresholds):
+    kernels = []
+    for kernel in sorted(counts):
+        threshold = thresholds.get(kernel)
+        kernels.append({
+            "name": kernel,
+            "instructions": counts[kernel],
+            "cycles": cycles.get(kernel),
+            "threshold": threshold,
+            "pass": (threshold is None) or (counts[kernel] <= threshold),
+        })
+    return {
+        "emulator": "renode",
+        "unit": "instructions",
+        "overhead": overhead,
+        "kernels": kernels,
+        "missing": sorted(set(thresholds) - set(counts)),
+        "no_baseline": sorted(set(counts) - set(thresholds)),
+        "pass": all(kernel["pass"] for kernel in kernels) and not (set(thresholds) - set(counts)),
+    }
+
+
+def print_report(report):
+    print("{:<28} {:>12} {:>10} {:>12} {:>8}  {}".format("kernel", "instructions", "cycles", "threshold", "delta",
+                                                         "result"))
+    for kernel in report["kernels"]:
+        threshold = kernel["threshold"]
+        cycles = "-" if kernel["cycles"] is None else kernel["cycles"]
+        if threshold is None:
+            print("{:<28} {:>12} {:>10} {:>12} {:>8}  no baseline".format(kernel["name"], kernel["instructions"],
+                                                                       cycles, "-", ""))
+            continue
+        delta = 100.0 * (kernel["instructions"] - threshold) / threshold if threshold else 0.0
+        print("{:<28} {:>12} {:>10} {:>12} {:>+7.1f}%  {}".format(kernel["name"], kernel["instructions"], cycles,
+                                                                threshold, delta, "pass" if kernel["pass"] else "FAIL"))
+    for kernel in report["missing"]:
+        print("{:<28} {:>12}  FAIL (not measured)".format(kernel, "-"))
+    print("marker overhead: {} instructions".format(report["overhead"]))
+    if report["no_baseline"]:
+        print("{} kernel(s) without baseline, record them with --update-thresholds (bench_thresholds target)".format(
+            len(report["no_baseline"])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="benchmark firmware")
+    parser.add_argument("--nm", default=shutil.which("arm-none-eabi-nm") or "arm-none-eabi-nm")
+    parser.add_argument("--renode", default=shutil.which("renode") or "renode")
+    parser.add_argument("--platform", required=True, help="Renode platform description (.repl)")
+    parser.add_argument("--thresholds", required=True, help="JSON file with the instruction limits per kernel")
+    parser.add_argument("--update-thresholds", action="store_true",
+                        help="write the measured counts plus --margin to the threshold file")
+    parser.add_argument("--margin", type=float, default=0.02, help="headroom of updated thresholds (fraction)")
+    parser.add_argument("--json", help="write the report as JSON")
+    parser.add_argument("--timeout", type=float, default=120.0, help="seconds until the run is aborted")
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.elf, args.nm)
+    missing = [marker for marker in MARKERS if marker not in symbols]
+    if missing:
+        sys.exit("error: {} not found in {}".format(", ".join(missing), args.elf))
+    names = {address: name[len(PREFIX):] for name, address in symbols.items() if name.startswith(PREFIX)}
+
+    with tempfile.TemporaryDirectory() as workdir:
+        log = os.path.join(workdir, "markers.log")
+        script = os.path.join(workdir, "bench.resc")
+        with open(script, "w") as file:
+            file.write(make_script(os.path.abspath(args.elf), os.path.abspath(args.platform), symbols, log))
+        counts, cycles, overhead = measure(run_renode(args.renode, script, log, args.timeout), names)
+
+    thresholds = {}
+    if os.path.exists(args.thresholds):
+        with open(args.thresholds) as file:
+            thresholds = json.load(file).get("kernels", {})
+
+    if args.update_thresholds:
+        updated = {kernel: int(math.ceil(count * (1.0 + args.margin))) for kernel, count in sorted(counts.items())}
+        with open(args.thresholds, "w") as file:
+            json.dump({"unit": "instructions", "kernels": updated}, file, indent=4)
+            file.write("\n")
+        print("thresholds written to {}".format(args.thresholds))
+        thresholds = updated
+
+    report = build_report(counts, cycles, overhead, thresholds)
+    print_report(report)
+    if args.json:
+        with open(args.json, "w") as file:
+            json.dump(report, file, indent=4)
+    return 0 if report["pass"] else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
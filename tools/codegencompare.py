@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Code size comparison of two object files with the same functions.
+
+Compares every function of the candidate object with the function of the same name in the reference object
+(e.g. register accesses through the mcal reg library against hand-written CMSIS code). Fails with exit code 1 if a
+candidate function is larger than its reference or has no reference.
+
+Usage: tools/codegencompare.py codegen_reg.o codegen_cmsis.o [--nm arm-none-eabi-nm]
+"""
+
+import argparse
+import shutil
+import subprocess
+import sys
+
+
+def read_functions(obj, nm):
+    """Returns {name: size} of the functions defined in obj."""
+    output = subprocess.run([nm, "--print-size", "--defined-only", obj], check=True, stdout=subprocess.PIPE,
+                            universal_newlines=True).stdout
+    functions = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if (len(fields) == 4) and (fields[2] in "tTwW"):
+            functions[fields[3]] = int(fields[1], 16)
+    return functions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("candidate", help="object file to check")
+    parser.add_argument("reference", help="object file with the reference implementation")
+    parser.add_argument("--nm", default=shutil.which("arm-none-eabi-nm") or "arm-none-eabi-nm")
+    args = parser.parse_args()
+
+    candidate = read_functions(args.candidate, args.nm)
+    reference = read_functions(args.reference, args.nm)
+
+    failed = False
+    print("{:<32} {:>10} {:>10}  {}".format("function", "candidate", "reference", "result"))
+    for name in sorted(candidate):
+        if name not in reference:
+            print("{:<32} {:>10} {:>10}  FAIL (no reference)".format(name, candidate[name], "-"))
+            failed = True
+            continue
+        larger = candidate[name] > reference[name]
+        failed = failed or larger
+        print("{:<32} {:>10} {:>10}  {}".format(name, candidate[name], reference[name], "FAIL" if larger else "ok"))
+    print("total {} / {} bytes".format(sum(candidate.values()), sum(reference.get(name, 0) for name in candidate)))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
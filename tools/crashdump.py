@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Decodes a crash record of application/components/crashdump and symbolizes it against the ELF file.
+
+Dump the record with gdb after the reset, before main() takes it:
+    (gdb) dump binary value crash.bin g_crashRecord
+or take the copy main() made:
+    (gdb) dump binary value crash.bin crashRecord
+
+Usage: tools/crashdump.py crash.bin build/application/Hello_Stm32.elf
+"""
+
+import argparse
+import binascii
+import shutil
+import struct
+import subprocess
+import sys
+
+MAGIC = 0xDEADC0DE
+VERSION = 1
+NUM_OF_STACK_WORDS = 32
+NUM_OF_TRACE_EVENTS = 16
+
+HEADER = ["magic", "version", "r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr",
+          "excReturn", "sp", "ipsr", "cfsr", "hfsr", "mmfar", "bfar", "numOfStackWords"]
+RECORD_WORDS = len(HEADER) + NUM_OF_STACK_WORDS + 1 + NUM_OF_TRACE_EVENTS + 1
+
+FLASH = (0x08000000, 0x08080000)
+CCMSRAM_CODE = (0x10000000, 0x10008000)
+
+CFSR_BITS = {
+    0: "IACCVIOL: instruction access violation",
+    1: "DACCVIOL: data access violation",
+    3: "MUNSTKERR: MemManage fault on unstacking",
+    4: "MSTKERR: MemManage fault on stacking",
+    5: "MLSPERR: MemManage fault during lazy FP state preservation",
+    7: "MMARVALID: MMFAR holds the fault address",
+    8: "IBUSERR: instruction bus error",
+    9: "PRECISERR: precise data bus error",
+    10: "IMPRECISERR: imprecise data bus error",
+    11: "UNSTKERR: bus fault on unstacking",
+    12: "STKERR: bus fault on stacking",
+    13: "LSPERR: bus fault during lazy FP state preservation",
+    15: "BFARVALID: BFAR holds the fault address",
+    16: "UNDEFINSTR: undefined instruction",
+    17: "INVSTATE: invalid state (EPSR.T cleared)",
+    18: "INVPC: invalid EXC_RETURN",
+    19: "NOCP: coprocessor access (FPU disabled?)",
+    24: "UNALIGNED: unaligned access",
+    25: "DIVBYZERO: division by zero",
+}
+
+HFSR_BITS = {
+    1: "VECTTBL: bus fault on vector table read",
+    30: "FORCED: escalated configurable fault",
+    31: "DEBUGEVT: debug event",
+}
+
+EXCEPTIONS = {3: "HardFault", 4: "MemManage", 5: "BusFault", 6: "UsageFault"}
+
+
+def parse(data):
+    if len(data) < RECORD_WORDS * 4:
+        raise ValueError("record too short: %d bytes, expected %d" % (len(data), RECORD_WORDS * 4))
+    words = struct.unpack("<%dI" % RECORD_WORDS, data[:RECORD_WORDS * 4])
+    record = dict(zip(HEADER, words))
+    pos = len(HEADER)
+    record["stack"] = list(words[pos:pos + NUM_OF_STACK_WORDS])
+    pos += NUM_OF_STACK_WORDS
+    record["traceHead"] = words[pos]
+    record["trace"] = list(words[pos + 1:pos + 1 + NUM_OF_TRACE_EVENTS])
+    record["crc"] = words[-1]
+
+    if record["magic"] != MAGIC:
+        raise ValueError("bad magic 0x%08x" % record["magic"])
+    if record["version"] != VERSION:
+        raise ValueError("unsupported record version %d" % record["version"])
+    crc = binascii.crc32(data[:(RECORD_WORDS - 1) * 4]) & 0xFFFFFFFF
+    if crc != record["crc"]:
+        raise ValueError("CRC mismatch: stored 0x%08x, computed 0x%08x" % (record["crc"], crc))
+    return record
+
+
+def is_code(address):
+    address &= ~1
+    return any(low <= address < high for (low, high) in (FLASH, CCMSRAM_CODE))
+
+
+class Symbolizer:
+    def __init__(self, elf, addr2line):
+        self.elf = elf
+        self.addr2line = addr2line if elf else None
+
+    def __call__(self, address):
+        if not self.addr2line or not is_code(address):
+            return ""
+        out = subprocess.run([self.addr2line, "-f", "-C", "-e", self.elf, "0x%x" % (address & ~1)],
+                             capture_output=True, text=True, check=False).stdout.split("\n")
+        if len(out) < 2 or out[0] == "??":
+            return ""
+        return "%s at %s" % (out[0], out[1])
+
+
+def bits(value, names):
+    return [text for (bit, text) in sorted(names.items()) if value & (1 << bit)]
+
+
+def report(record, symbolize):
+    lines = []
+    exception = record["ipsr"] & 0x1FF
+    lines.append("Fault: %s (exception %d)" % (EXCEPTIONS.get(exception, "unknown"), exception))
+    lines.append("  CFSR  0x%08x" % record["cfsr"])
+    lines.extend("        " + text for text in bits(record["cfsr"], CFSR_BITS))
+    lines.append("  HFSR  0x%08x" % record["hfsr"])
+    lines.extend("        " + text for text in bits(record["hfsr"], HFSR_BITS))
+    if record["cfsr"] & (1 << 7):
+        lines.append("  MMFAR 0x%08x" % record["mmfar"])
+    if record["cfsr"] & (1 << 15):
+        lines.append("  BFAR  0x%08x" % record["bfar"])
+
+    lines.append("Registers (EXC_RETURN 0x%08x, %s stack at 0x%08x):" %
+                 (record["excReturn"], "process" if record["excReturn"] & 4 else "main", record["sp"]))
+    for name in ("r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr"):
+        symbol = symbolize(record[name]) if name in ("lr", "pc") else ""
+        lines.append("  %-4s  0x%08x  %s" % (name, record[name], symbol))
+
+    # EXC_RETURN bit 4 cleared: extended frame including the FP context
+    frame_bytes = 32 if record["excReturn"] & 0x10 else 104
+    lines.append("Stack (%d words above the %d byte exception frame):" % (record["numOfStackWords"], frame_bytes))
+    for i in range(min(record["numOfStackWords"], NUM_OF_STACK_WORDS)):
+        value = record["stack"][i]
+        symbol = symbolize(value)
+        lines.append("  [sp+0x%02x]  0x%08x  %s" % (frame_bytes + 4 * i, value, symbol))
+
+    count = min(record["traceHead"], NUM_OF_TRACE_EVENTS)
+    lines.append("Trace (last %d of %d events, oldest first):" % (count, record["traceHead"]))
+    for i in range(record["traceHead"] - count, record["traceHead"]):
+        lines.append("  #%-6d 0x%08x" % (i, record["trace"][i % NUM_OF_TRACE_EVENTS]))
+    return "\n".join(line.rstrip() for line in lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("record", help="binary crash record dumped from the target")
+    parser.add_argument("elf", nargs="?", help="ELF file of the crashed firmware, used for symbolization")
+    parser.add_argument("--addr2line", default=shutil.which("arm-none-eabi-addr2line") or "arm-none-eabi-addr2line")
+    args = parser.parse_args()
+
+    with open(args.record, "rb") as file:
+        data = file.read()
+    try:
+        record = parse(data)
+    except ValueError as error:
+        print("invalid crash record: %s" % error, file=sys.stderr)
+        return 1
+    print(report(record, Symbolizer(args.elf, args.addr2line)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,338 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Register map generator for the mcal reg library.
+
+Reads a CMSIS device header (peripheral structs, instance and _BASE definitions, _Pos/_Msk field definitions) and
+writes a header with a mcal::reg map template per peripheral struct and an alias per instance, e.g.
+
+    template<uintptr_t Base>
+    struct RccMap {
+        struct Cr : reg::Register<Base + 0x00U, 0x00000500U> {
+            using Hseon = reg::Field<Cr, 16U, 1U>;
+            ...
+    using Rcc = RccMap<0x40021000U>;
+
+The CMSIS header has neither reset values nor field access types. Both come from a JSON file with
+"reset": {"peripherals": {"RCC": {"CR": "0x00000500"}}, "instances": {"GPIOA": {"MODER": "0xABFFFFFF"}}} and
+"access": {"GPIO_BSRR": "WriteOnly", "RCC_CR_HSERDY": "ReadOnly"} (whole register or single field). "aliases":
+{"GPIO_AFR0": "AFRL"} gives the register name used by the field definitions where it differs from the struct. A register
+with instance specific reset values gets a template parameter <Register>Reset. Registers narrower than 32 bit,
+structs of structs and non contiguous fields are skipped and listed in the generated header.
+
+Usage: tools/regmapgen.py stm32g474xx.h --extra stm32g474xx_regs.json -o stm32g474xx_regs.h
+       [--check stm32g474xx_regs_check.cpp] --namespace stm32g4
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+STRUCT_RE = re.compile(r"typedef\s+struct\s*\{(?P<body>[^{}]*)\}\s*(?P<name>\w+)_TypeDef\s*;")
+MEMBER_RE = re.compile(r"^\s*(?P<qualifier>__IO|__IOM|__I|__IM|__O|__OM)?\s*(?P<type>\w+)\s+(?P<name>\w+)"
+                       r"\s*(?:\[\s*(?P<count>\d+)\s*\])?\s*;")
+DEFINE_RE = re.compile(r"^\s*#define\s+(?P<name>\w+)\s+(?P<value>.*?)\s*(?:/\*.*)?$", re.MULTILINE)
+INSTANCE_RE = re.compile(r"^\(\s*\(\s*(?P<type>\w+)_TypeDef\s*\*\s*\)\s*(?P<base>\w+)\s*\)$")
+TYPE_SIZES = {"uint32_t": 4, "uint16_t": 2, "uint8_t": 1}
+ACCESS = {"__I": "ReadOnly", "__IM": "ReadOnly", "__O": "WriteOnly", "__OM": "WriteOnly"}
+
+
+class Register:
+    def __init__(self, name, member, offset, access):
+        self.name = name
+        self.member = member
+        self.offset = offset
+        self.access = access
+        self.fields = []
+
+
+def camel(name):
+    """CMSIS name to the CamelCase of the maps: AHB2ENR -> Ahb2enr, ADC12_COMMON -> Adc12Common."""
+    return "".join(part[:1].upper() + part[1:].lower() for part in name.split("_") if part)
+
+
+def field_alias(name, register):
+    """Field name in the map, a field must not be named like its register or hide a member of reg::Register."""
+    alias = camel(name)
+    return (alias + "Field") if (alias in (camel(register.name), "Address", "Reset")) else alias
+
+
+def read_defines(text):
+    defines = {}
+    for match in DEFINE_RE.finditer(text):
+        defines.setdefault(match.group("name"), match.group("value"))
+    return defines
+
+
+def evaluate(expression, defines, depth=0):
+    """Evaluates a constant expression of integer literals and other defines."""
+    if depth > 16:
+        raise ValueError("recursion in " + expression)
+
+    def substitute(match):
+        token = match.group(0)
+        if token[0].isdigit():
+            return re.sub(r"[uUlL]+$", "", token)
+        if token not in defines:
+            raise ValueError("unknown symbol " + token)
+        return "({})".format(evaluate(defines[token], defines, depth + 1))
+
+    python = re.sub(r"\b(?:0[xX][0-9a-fA-F]+|\d+)[uUlL]*\b|\b[A-Za-z_]\w*\b", substitute, expression)
+    if not re.fullmatch(r"[\s\d()+\-*<>|&~xXa-fA-F]*", python):
+        raise ValueError("not a constant expression: " + expression)
+    return eval(python, {"__builtins__": {}}) & 0xFFFFFFFF
+
+
+def read_structs(text, skipped):
+    """Returns {peripheral: [Register]} of the structs with plain 32 bit registers."""
+    structs = {}
+    for match in STRUCT_RE.finditer(text):
+        peripheral = match.group("name")
+        body = re.sub(r"/\*.*?\*/|//[^\n]*", "", match.group("body"), flags=re.DOTALL)
+        registers = []
+        offset = 0
+        for line in body.split(";"):
+            if not line.strip():
+                continue
+            member = MEMBER_RE.match(line + ";")
+            if (member is None) or (member.group("type") not in TYPE_SIZES):
+                skipped.append("{}: member '{}' is not a register".format(peripheral, " ".join(line.split())))
+                registers = None
+                break
+            size = TYPE_SIZES[member.group("type")]
+            count = int(member.group("count") or 1)
+            offset = (offset + size - 1) // size * size
+            name = member.group("name")
+            if not name.startswith("RESERVED"):
+                if size != 4:
+                    skipped.append("{}_{}: {} bit register".format(peripheral, name, size * 8))
+                else:
+                    access = ACCESS.get(member.group("qualifier"), "ReadWrite")
+                    for index in range(count):
+                        if member.group("count"):
+                            registers.append(Register(name + str(index), "{}[{}]".format(name, index),
+                                                      offset + index * size, access))
+                        else:
+                            registers.append(Register(name, name, offset, access))
+            offset += size * count
+        if registers is not None:
+            structs[peripheral] = registers
+    return structs
+
+
+def read_fields(structs, defines, access, aliases, skipped):
+    """Adds the _Pos/_Msk fields to the registers, the prefix is the peripheral name or its first part."""
+    for peripheral, registers in structs.items():
+        prefixes = {peripheral, peripheral.split("_")[0]}
+        names = sorted(((aliases.get(peripheral + "_" + register.name, register.name), register)
+                        for register in registers), key=lambda entry: len(entry[0]), reverse=True)
+        for define in defines:
+            if not define.endswith("_Pos"):
+                continue
+            symbol = define[:-len("_Pos")]
+            if (symbol + "_Msk") not in defines:
+                continue
+            for cmsis, register in names:
+                prefix = next((p for p in prefixes if symbol.startswith(p + "_" + cmsis + "_")), None)
+                if prefix is not None:
+                    break
+            else:
+                continue
+            name = symbol[len(prefix) + len(cmsis) + 2:]
+            if any(field[0] == name for field in register.fields):
+                continue
+            pos = evaluate(defines[define], defines)
+            mask = evaluate(defines[symbol + "_Msk"], defines)
+            width = bin(mask).count("1")
+            if (mask == 0) or (mask != (((1 << width) - 1) << pos)):
+                skipped.append("{}: mask 0x{:08X} is no contiguous field at bit {}".format(symbol, mask, pos))
+                continue
+            field_access = access.get(symbol, access.get(peripheral + "_" + register.name, register.access))
+            register.fields.append((name, pos, width, field_access, symbol))
+        for register in registers:
+            register.access = access.get(peripheral + "_" + register.name, register.access)
+            register.fields.sort(key=lambda field: (field[1], field[0]))
+
+
+def read_instances(defines, structs):
+    """Returns [(instance, peripheral, base address, base symbol)] sorted by address."""
+    instances = []
+    for name, value in defines.items():
+        match = INSTANCE_RE.match(value)
+        if (match is not None) and (match.group("type") in structs):
+            base = match.group("base")
+            instances.append((name, match.group("type"), evaluate(base, defines), base))
+    return sorted(instances, key=lambda instance: (instance[2], instance[0]))
+
+
+def generate(header, structs, instances, reset, namespace, skipped):
+    defaults = reset.get("peripherals", {})
+    overrides = reset.get("instances", {})
+    lines = []
+    emit = lines.append
+    emit("// Generated by tools/regmapgen.py from {}, do not edit".format(os.path.basename(header)))
+    emit("")
+    emit("#pragma once")
+    emit("")
+    emit("#include <cstdint>")
+    emit("")
+    emit('#include "reg.h"')
+    emit("")
+    emit("namespace mcal {")
+    emit("namespace {} {{".format(namespace))
+
+    parameters = {}
+    for peripheral, registers in sorted(structs.items()):
+        members = [instance for instance, struct, _, _ in instances if struct == peripheral]
+        if not members:
+            continue
+        parameters[peripheral] = [register for register in registers
+                                  if any(register.name in overrides.get(member, {}) for member in members)]
+        template = "uintptr_t Base" + "".join(", uint32_t {}Reset = 0x{:08X}U".format(
+            camel(register.name), int(defaults.get(peripheral, {}).get(register.name, "0"), 16))
+            for register in parameters[peripheral])
+        emit("")
+        emit("template<{}>".format(template))
+        emit("struct {}Map {{".format(camel(peripheral)))
+        for index, register in enumerate(registers):
+            struct = camel(register.name)
+            if register in parameters[peripheral]:
+                value = ", {}Reset".format(struct)
+            elif register.name in defaults.get(peripheral, {}):
+                value = ", 0x{:08X}U".format(int(defaults[peripheral][register.name], 16))
+            else:
+                value = ""
+            if index > 0:
+                emit("")
+            emit("    struct {} : reg::Register<Base + 0x{:02X}U{}> {{".format(struct, register.offset, value))
+            for name, pos, width, access, _ in register.fields:
+                alias = field_alias(name, register)
+                arguments = "{}, {}U, {}U".format(struct, pos, width)
+                if access != "ReadWrite":
+                    arguments += ", uint32_t, reg::Access_t::" + access
+                emit("        using {:<12}= reg::Field<{}>;".format(alias + " ", arguments))
+            emit("    };")
+        emit("};")
+
+    emit("")
+    for instance, peripheral, base, _ in instances:
+        values = [overrides.get(instance, {}).get(register.name) for register in parameters[peripheral]]
+        while values and (values[-1] is None):
+            values.pop()
+        arguments = "".join(", 0x{:08X}U".format(int(value if value is not None else defaults.get(
+            peripheral, {}).get(register.name, "0"), 16)) for value, register in zip(values, parameters[peripheral]))
+        emit("using {:<24}= {}Map<0x{:08X}U{}>;".format(camel(instance) + " ", camel(peripheral), base, arguments))
+
+    if skipped:
+        emit("")
+        emit("// Not generated:")
+        for reason in skipped:
+            emit("//   " + reason)
+    emit("")
+    emit("}}   // namespace {}".format(namespace))
+    emit("}   // namespace mcal")
+    return "\n".join(lines) + "\n"
+
+
+def generate_check(header, output, structs, instances, namespace):
+    """Source with static_asserts of all addresses and field masks against the CMSIS header."""
+    lines = []
+    emit = lines.append
+    emit("// Generated by tools/regmapgen.py from {}, do not edit".format(os.path.basename(header)))
+    emit("")
+    emit('#include "{}"'.format(os.path.basename(output)))
+    emit("")
+    emit("#include <cstddef>")
+    emit("")
+    emit('#include "{}"'.format(os.path.basename(header)))
+    emit("")
+    emit("namespace mcal {")
+    emit("namespace {} {{".format(namespace))
+    checked = set()
+    for instance, peripheral, _, base in instances:
+        alias = camel(instance)
+        emit("")
+        for register in structs[peripheral]:
+            emit("static_assert({}::{}::Address == ({} + offsetof({}_TypeDef, {})), \"{}->{}\");".format(
+                alias, camel(register.name), base, peripheral, register.member, instance, register.member))
+        if peripheral in checked:
+            continue
+        checked.add(peripheral)
+        for register in structs[peripheral]:
+            for name, _, _, _, symbol in register.fields:
+                emit("static_assert({}::{}::{}::Mask == {}_Msk, \"{}\");".format(
+                    alias, camel(register.name), field_alias(name, register), symbol, symbol))
+    emit("")
+    emit("}}   // namespace {}".format(namespace))
+    emit("}   // namespace mcal")
+    return "\n".join(lines) + "\n"
+
+
+def write(path, text):
+    """Writes the file only if changed, so that dependent sources are not rebuilt."""
+    if os.path.exists(path):
+        with open(path) as file:
+            if file.read() == text:
+                return
+    os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
+    with open(path, "w") as file:
+        file.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("header", help="CMSIS device header, e.g. stm32g474xx.h")
+    parser.add_argument("--extra", help="JSON file with reset values and access types")
+    parser.add_argument("-o", "--output", required=True, help="generated header")
+    parser.add_argument("--check", help="source file with static_asserts against the CMSIS header")
+    parser.add_argument("--namespace", required=True, help="namespace inside mcal, e.g. stm32g4")
+    args = parser.parse_args()
+
+    with open(args.header, encoding="latin-1") as file:
+        text = file.read()
+    extra = {}
+    if args.extra:
+        with open(args.extra) as file:
+            extra = json.load(file)
+
+    skipped = []
+    defines = read_defines(text)
+    structs = read_structs(text, skipped)
+    read_fields(structs, defines, extra.get("access", {}), extra.get("aliases", {}), skipped)
+    instances = read_instances(defines, structs)
+
+    for instance in extra.get("reset", {}).get("instances", {}):
+        if instance not in {name for name, _, _, _ in instances}:
+            print("regmapgen: unknown instance " + instance, file=sys.stderr)
+            return 1
+
+    write(args.output, generate(args.header, structs, instances, extra.get("reset", {}), args.namespace, skipped))
+    if args.check:
+        write(args.check, generate_check(args.header, args.output, structs, instances, args.namespace))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Flash/RAM size report per component and per symbol from the linker map and the ELF symbol table.
+
+Every input section of the map file is attributed to the component it comes from (the library archive, the
+application objects, the C/C++ runtime) and to the memory region of its output section. Initialized data counts
+for RAM and for flash (load image). The report is compared against a stored baseline and checked against
+budgets; a missing baseline file and an exceeded budget fail with exit code 1.
+
+Usage: tools/sizereport.py Hello_Stm32.map Hello_Stm32.elf [--baseline size_baseline.json] [--budgets budgets.json]
+       [--json report.json] [--update-baseline]
+
+Budget file:  {"flash": 65536, "ram": 16384, "components": {"mcal_dio": {"flash": 1024}}}
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+REGIONS = (
+    ("flash", 0x08000000, 0x08080000),
+    ("ccmsram", 0x10000000, 0x10008000),
+    ("ram", 0x20000000, 0x20020000),
+)
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?)?\s*$")
+OUTPUT_VALUES = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)(?:\s+load address 0x([0-9a-f]+))?\s*$")
+INPUT_SECTION = re.compile(r"^ (\S+)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s*(.*))?$")
+INPUT_VALUES = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(.+)$")
+
+NOBITS = (".bss", ".noinit", ".ccmram_bss", "._user_heap_stack")
+
+RUNTIME = {"c": "libc", "c_nano": "libc", "g": "libc", "g_nano": "libc", "m": "libm", "gcc": "libgcc",
+           "stdc++": "libstdc++", "stdc++_nano": "libstdc++", "supc++": "libstdc++", "supc++_nano": "libstdc++",
+           "nosys": "libc"}
+
+
+def region_of(address):
+    for name, low, high in REGIONS:
+        if low <= address < high:
+            return name
+    return None
+
+
+def component_of(path):
+    """Maps an input file of the map file to a component name."""
+    if not path:
+        return "linker"
+    archive = re.match(r"^(.*?)\((.*)\)$", path)
+    if archive:
+        name = os.path.basename(archive.group(1))
+        name = re.sub(r"^lib", "", re.sub(r"\.a$", "", name))
+        return RUNTIME.get(name, name)
+    base = os.path.basename(path)
+    if base.startswith(("startup_", "system_")):
+        return "cmsis"
+    if base.startswith("crt") or "/gcc/" in path or "/lib/gcc" in path:
+        return "libgcc"
+    return "app"
+
+
+def parse_map(path):
+    """Returns a list of (component, region, size) for all allocated input sections."""
+    entries = []
+    with open(path) as file:
+        lines = iter(file.read().splitlines())
+
+    for line in lines:
+        if line.startswith("Linker script and memory map"):
+            break
+
+    output = None           # (vma region, load region)
+    pending_output = None
+    pending_input = None
+    for line in lines:
+        if pending_output is not None:
+            match = OUTPUT_VALUES.match(line)
+            pending_output, name = None, pending_output
+            if match:
+                output = make_output(name, match.group(1), match.group(3))
+            continue
+        if pending_input is not None:
+            match = INPUT_VALUES.match(line)
+            pending_input = None
+            if match and output:
+                add_input(entries, output, int(match.group(2), 16), match.group(3))
+            continue
+
+        if line.startswith("."):
+            match = OUTPUT_SECTION.match(line)
+            if not match:
+                output = None
+            elif match.group(2) is None:
+                pending_output = match.group(1)
+            else:
+                output = make_output(match.group(1), match.group(2), match.group(4))
+            continue
+        if line.startswith("/DISCARD/") or (line and not line[0].isspace()):
+            output = None
+            continue
+        if output is None or not line.startswith(" ") or line.startswith("  "):
+            continue
+
+        match = INPUT_SECTION.match(line)
+        if not match or match.group(1).startswith("*") and match.group(1) != "*fill*":
+            continue
+        if match.group(2) is None:
+            pending_input = match.group(1)
+        else:
+            path = match.group(4).strip() if match.group(1) != "*fill*" else ""
+            add_input(entries, output, int(match.group(3), 16), path)
+    return entries
+
+
+def make_output(name, address, load):
+    region = region_of(int(address, 16))
+    if region is None or name.startswith((".debug", ".comment", ".ARM.attributes")):
+        return None
+    # sections without contents occupy no flash even if the map lists a load address
+    load_region = region_of(int(load, 16)) if load and not name.startswith(NOBITS) else None
+    component = "heap/stack" if name == "._user_heap_stack" else None
+    return (region, load_region if load_region != region else None, component)
+
+
+def add_input(entries, output, size, path):
+    if size == 0:
+        return
+    region, load_region, component = output
+    component = component or component_of(path)
+    entries.append((component, region, size))
+    if load_region:
+        entries.append((component, load_region, size))
+
+
+def read_symbols(elf, nm):
+    output = subprocess.run([nm, "-S", "-C", "--defined-only", "--size-sort", elf],
+                            capture_output=True, text=True, check=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        region = region_of(int(parts[0], 16))
+        if region:
+            symbols.append({"name": parts[3], "region": region, "size": int(parts[1], 16), "type": parts[2]})
+    symbols.sort(key=lambda symbol: -symbol["size"])
+    return symbols
+
+
+def build_report(entries, symbols):
+    regions = [name for name, _, _ in REGIONS]
+    components = {}
+    totals = dict.fromkeys(regions, 0)
+    for component, region, size in entries:
+        sizes = components.setdefault(component, dict.fromkeys(regions, 0))
+        sizes[region] += size
+        totals[region] += size
+    return {"totals": totals, "components": components, "symbols": symbols}
+
+
+def delta(value, old):
+    if old is None:
+        return ""
+    diff = value - old
+    return "%+d" % diff if diff else ""
+
+
+def print_report(report, baseline, top):
+    regions = list(report["totals"])
+    base_components = baseline["components"] if baseline else {}
+    print("%-20s" % "component" + "".join("%10s %8s" % (region, "diff") for region in regions))
+    for component in sorted(report["components"], key=lambda c: -report["components"][c]["flash"]):
+        sizes = report["components"][component]
+        old = base_components.get(component, {}) if baseline else None
+        print("%-20s" % component + "".join(
+            "%10d %8s" % (sizes[region], delta(sizes[region], old.get(region, 0) if old is not None else None))
+            for region in regions))
+    for component in sorted(set(base_components) - set(report["components"])):
+        print("%-20s (removed)" % component)
+    print("%-20s" % "total" + "".join(
+        "%10d %8s" % (report["totals"][region],
+                      delta(report["totals"][region], baseline["totals"].get(region, 0) if baseline else None))
+        for region in regions))
+
+    print("\nlargest symbols:")
+    base_symbols = {(s["name"], s["region"]): s["size"] for s in baseline["symbols"]} if baseline else {}
+    for symbol in report["symbols"][:top]:
+        old = base_symbols.get((symbol["name"], symbol["region"])) if baseline else None
+        print("  %8d %8s  %-8s %s" % (symbol["size"], delta(symbol["size"], old if old is not None else 0)
+                                      if baseline else "", symbol["region"], symbol["name"]))
+
+
+def check_budgets(report, budgets):
+    violations = []
+    for region, limit in budgets.items():
+        if region != "components" and report["totals"].get(region, 0) > limit:
+            violations.append("total %s %d > %d" % (region, report["totals"][region], limit))
+    for component, limits in budgets.get("components", {}).items():
+        for region, limit in limits.items():
+            size = report["components"].get(component, {}).get(region, 0)
+            if size > limit:
+                violations.append("%s %s %d > %d" % (component, region, size, limit))
+    return violations
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("elf", help="linked firmware")
+    parser.add_argument("--nm", default=shutil.which("arm-none-eabi-nm") or "arm-none-eabi-nm")
+    parser.add_argument("--baseline", help="stored report to compare against")
+    parser.add_argument("--update-baseline", action="store_true", help="write the report to the baseline file")
+    parser.add_argument("--budgets", help="JSON file with size limits")
+    parser.add_argument("--json", help="write the report as JSON")
+    parser.add_argument("--top", type=int, default=20, help="number of symbols listed")
+    args = parser.parse_args()
+
+    report = build_report(parse_map(args.map), read_symbols(args.elf, args.nm))
+
+    baseline = None
+    missing_baseline = False
+    if args.baseline and os.path.exists(args.baseline) and not args.update_baseline:
+        with open(args.baseline) as file:
+            baseline = json.load(file)
+    elif args.baseline and not args.update_baseline:
+        missing_baseline = True
+    print_report(report, baseline, args.top)
+
+    if args.json:
+        with open(args.json, "w") as file:
+            json.dump(report, file, indent=1, sort_keys=True)
+    if args.update_baseline and args.baseline:
+        with open(args.baseline, "w") as file:
+            json.dump(report, file, indent=1, sort_keys=True)
+        print("\nbaseline %s updated" % args.baseline)
+
+    if args.budgets:
+        with open(args.budgets) as file:
+            violations = check_budgets(report, json.load(file))
+        for violation in violations:
+            print("size budget exceeded: %s" % violation, file=sys.stderr)
+        if violations:
+            return 1
+    if missing_baseline:
+        print("error: no baseline %s, store one with --update-baseline (<target>_sizebaseline)" % args.baseline,
+              file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+# MIT License
+
+# Copyright (c) 2023 Ralf Hochhausen
+
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""Static worst-case stack depth per entry point (Reset_Handler and all exception/interrupt handlers).
+
+Frame sizes come from the .su files that GCC writes with -fstack-usage, the call graph is taken from the
+disassembly of the ELF file (direct calls and tail calls). Indirect calls and recursion can not be bounded
+statically, they are flagged in the report. Functions without .su information (assembler, prebuilt
+libraries) count with zero bytes and are flagged as well.
+
+Usage: tools/stackusage.py --su-dir build build/application/Hello_Stm32.elf
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+EXCEPTION_FRAME = 32        # r0-r3, r12, lr, pc, xpsr
+EXCEPTION_FRAME_FP = 104    # plus s0-s15, fpscr and alignment
+
+SU_LINE = re.compile(r"^(.*?):(\d+):(\d+):(.*)\t(\d+)\t(\S+)$")
+FUNCTION = re.compile(r"^[0-9a-f]+ <(.*)>:$")
+BRANCH = re.compile(r"^\s*[0-9a-f]+:\s+(b[a-z.]*)\s+([0-9a-f]+) <(.*)>$")
+INDIRECT = re.compile(r"^\s*[0-9a-f]+:\s+(blx|bx)\s+(r\d+|ip)\b")
+
+
+def base_name(signature):
+    """Reduces a C or demangled C++ signature to its qualified name (no return type, no parameters)."""
+    name = signature.split("(")[0].strip()
+    return name.split(" ")[-1]
+
+
+def read_frames(su_dir):
+    frames = {}
+    for root, _, files in os.walk(su_dir):
+        for file in files:
+            if not file.endswith(".su"):
+                continue
+            with open(os.path.join(root, file)) as su:
+                for line in su:
+                    match = SU_LINE.match(line.rstrip("\n"))
+                    if not match:
+                        continue
+                    name = base_name(match.group(4))
+                    size = int(match.group(5))
+                    dynamic = match.group(6) != "static"
+                    # overloads share the base name, keep the largest frame
+                    old = frames.get(name, (0, False))
+                    frames[name] = (max(old[0], size), old[1] or dynamic)
+    return frames
+
+
+def read_call_graph(elf, objdump):
+    output = subprocess.run([objdump, "-d", "-C", "--no-show-raw-insn", elf],
+                            capture_output=True, text=True, check=True).stdout
+    graph = {}
+    indirect = set()
+    current = None
+    for line in output.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = base_name(match.group(1))
+            graph.setdefault(current, set())
+            continue
+        if current is None:
+            continue
+        match = BRANCH.match(line)
+        if match:
+            target = match.group(3)
+            if "+" not in target:
+                callee = base_name(target)
+                if callee != current or match.group(1).startswith("bl"):
+                    graph[current].add(callee)
+            continue
+        if INDIRECT.match(line):
+            indirect.add(current)
+    return graph, indirect
+
+
+class Analyzer:
+    def __init__(self, frames, graph, indirect):
+        self.frames = frames
+        self.graph = graph
+        self.indirect = indirect
+        self.memo = {}
+
+    def depth(self, function, active=()):
+        """Returns (bytes, path, flags) of the deepest call chain starting at function."""
+        if function in self.memo:
+            return self.memo[function]
+        if function in active:
+            return 0, [function], {"recursion"}
+
+        frame, dynamic = self.frames.get(function, (0, False))
+        flags = set()
+        if function not in self.frames:
+            flags.add("unknown")
+        if dynamic:
+            flags.add("dynamic")
+        if function in self.indirect:
+            flags.add("indirect")
+
+        deepest, path = 0, []
+        for callee in sorted(self.graph.get(function, ())):
+            size, callee_path, callee_flags = self.depth(callee, active + (function,))
+            flags |= callee_flags
+            if size > deepest or not path:
+                deepest, path = size, callee_path
+        result = (frame + deepest, [function] + path, flags)
+        if "recursion" not in flags:
+            self.memo[function] = result
+        return result
+
+
+def entry_points(graph):
+    return sorted(name for name in graph if name.endswith("Handler"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="linked firmware")
+    parser.add_argument("--su-dir", required=True, help="build directory containing the .su files")
+    parser.add_argument("--objdump", default=shutil.which("arm-none-eabi-objdump") or "arm-none-eabi-objdump")
+    parser.add_argument("--no-fp", action="store_true", help="exception frames without FP context")
+    parser.add_argument("--limit", type=lambda x: int(x, 0), default=0,
+                        help="reserved stack size in bytes, fail if the worst case exceeds it")
+    args = parser.parse_args()
+
+    frames = read_frames(args.su_dir)
+    graph, indirect = read_call_graph(args.elf, args.objdump)
+    analyzer = Analyzer(frames, graph, indirect)
+    exception_frame = EXCEPTION_FRAME if args.no_fp else EXCEPTION_FRAME_FP
+
+    print("%-32s %8s  %-28s %s" % ("entry point", "bytes", "flags", "deepest path"))
+    thread, nested, deepest_handler = 0, 0, 0
+    for entry in entry_points(graph):
+        size, path, flags = analyzer.depth(entry)
+        if entry == "Reset_Handler":
+            thread = size
+        else:
+            size += exception_frame
+            nested += size
+            deepest_handler = max(deepest_handler, size)
+        print("%-32s %8d  %-28s %s" % (entry, size, ",".join(sorted(flags)), " > ".join(path)))
+
+    # All interrupts run on the same preemption priority unless configured otherwise, so only one handler
+    # is stacked on top of the thread. Nesting every handler is the bound for fully distinct priorities.
+    single = thread + deepest_handler
+    print("\nthread + deepest handler:        %6d bytes" % single)
+    print("thread + all handlers nested:    %6d bytes" % (thread + nested))
+    if args.limit:
+        print("reserved stack:                  %6d bytes" % args.limit)
+        if single > args.limit:
+            print("stack usage may exceed the reserved stack", file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())